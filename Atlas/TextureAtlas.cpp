@@ -0,0 +1,98 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+    // Transparent gap between images so neighbours never bleed into each other
+    const unsigned int PADDING = 1;
+}
+
+SpriteHandle TextureAtlas::add(const std::string& path)
+{
+    auto found = m_indices.find(path);
+    if (found != m_indices.end())
+    {
+        return SpriteHandle{found->second};
+    }
+
+    sf::Image image;
+    image.loadFromFile(path);  // SFML reports failures; the image is then simply empty
+
+    int index = static_cast<int>(m_images.size());
+    m_images.push_back(image);
+    m_rects.push_back(sf::IntRect());
+    m_indices[path] = index;
+    return SpriteHandle{index};
+}
+
+bool TextureAtlas::build(bool createTexture)
+{
+    // Shelf packing: tallest images first, left to right, a new shelf whenever a row is full
+    std::vector<int> order(m_images.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](int a, int b)
+    {
+        return m_images[a].getSize().y > m_images[b].getSize().y;
+    });
+
+    // Aim for a roughly square atlas that is at least as wide as the widest image
+    unsigned int area = 0;
+    unsigned int widest = 1;
+    for (const sf::Image& image : m_images)
+    {
+        area += (image.getSize().x + PADDING) * (image.getSize().y + PADDING);
+        widest = std::max(widest, image.getSize().x + PADDING);
+    }
+    unsigned int atlasWidth = widest;
+    while (atlasWidth * atlasWidth < area)
+    {
+        atlasWidth *= 2;
+    }
+
+    unsigned int x = 0;
+    unsigned int y = 0;
+    unsigned int shelfHeight = 0;
+    for (int index : order)
+    {
+        sf::Vector2u size = m_images[index].getSize();
+        if (x + size.x > atlasWidth)
+        {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        m_rects[index] = sf::IntRect(x, y, size.x, size.y);
+        x += size.x + PADDING;
+        shelfHeight = std::max(shelfHeight, size.y + PADDING);
+    }
+    unsigned int atlasHeight = std::max(y + shelfHeight, 1u);
+
+    if (!createTexture)
+    {
+        m_images.clear();
+        m_images.shrink_to_fit();
+        return true;
+    }
+
+    m_texture = std::make_unique<sf::Texture>();
+    if (atlasWidth > sf::Texture::getMaximumSize() || atlasHeight > sf::Texture::getMaximumSize() ||
+        !m_texture->create(atlasWidth, atlasHeight))
+    {
+        return false;
+    }
+
+    // One upload for the whole atlas
+    sf::Image atlas;
+    atlas.create(atlasWidth, atlasHeight, sf::Color::Transparent);
+    for (size_t i = 0; i < m_images.size(); ++i)
+    {
+        atlas.copy(m_images[i], m_rects[i].left, m_rects[i].top);
+    }
+    m_texture->update(atlas);
+
+    m_images.clear();
+    m_images.shrink_to_fit();
+    return true;
+}
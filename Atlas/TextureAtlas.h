@@ -0,0 +1,70 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Lightweight reference to one image in a TextureAtlas
+struct SpriteHandle
+{
+    int index = -1;
+
+    bool isValid() const
+    {
+        return index >= 0;
+    }
+};
+
+// Texture atlas shared by the games. Every sprite image is loaded once and
+// packed into a single texture, so sprites share one GPU texture and can be
+// drawn together in one batch, carrying only a handle or sub-rect.
+//
+//     TextureAtlas atlas;
+//     SpriteHandle tree = atlas.add("graphics/tree.png");
+//     ...
+//     atlas.build();
+//     atlas.apply(spriteTree, tree);
+//
+// Add every image first, then call build(). An image that fails to load
+// (SFML reports why) still gets a handle; it takes no space and shows nothing.
+class TextureAtlas
+{
+public:
+    // Load an image, or return the existing handle if this path was added before
+    SpriteHandle add(const std::string& path);
+
+    // Pack the loaded images into the atlas texture; false if it cannot be created.
+    // Without createTexture only the rects are laid out and no texture is ever
+    // constructed, so no graphics context is needed (headless replay playback)
+    bool build(bool createTexture = true);
+
+    // Only valid after build(true)
+    const sf::Texture& getTexture() const
+    {
+        return *m_texture;
+    }
+
+    // The handle's image within the atlas texture
+    const sf::IntRect& getRect(SpriteHandle handle) const
+    {
+        return m_rects[handle.index];
+    }
+
+    // Point a sprite at the atlas texture, if there is one, and the handle's sub-rect
+    void apply(sf::Sprite& sprite, SpriteHandle handle) const
+    {
+        if (m_texture)
+        {
+            sprite.setTexture(*m_texture);
+        }
+        sprite.setTextureRect(m_rects[handle.index]);
+    }
+
+private:
+    std::unordered_map<std::string, int> m_indices;
+    std::vector<sf::Image> m_images;    // released once packed
+    std::vector<sf::IntRect> m_rects;
+    std::unique_ptr<sf::Texture> m_texture;  // every sf::Texture needs a GL context, even an empty one
+};
@@ -0,0 +1,17 @@
+#include "SoundBank.h"
+
+int SoundBank::load(const std::string& path, int priority)
+{
+    sf::SoundBuffer buffer;
+    if (!buffer.loadFromFile(path))
+    {
+        return -1;
+    }
+    return add(buffer, priority);
+}
+
+int SoundBank::add(const sf::SoundBuffer& buffer, int priority)
+{
+    m_effects.push_back({buffer, priority});
+    return static_cast<int>(m_effects.size()) - 1;
+}
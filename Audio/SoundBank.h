@@ -0,0 +1,45 @@
+#pragma once
+
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <deque>
+#include <string>
+
+// Every sound effect a game uses, each decoded once into a SoundBuffer at
+// load time and looked up by the small integer id add() or load() returns.
+// Each effect also carries a priority, which VoicePool uses to decide what
+// to cut off when it runs out of voices.
+class SoundBank
+{
+public:
+    // Decode a sound file; returns its id, or -1 if it could not be loaded
+    int load(const std::string& path, int priority = 0);
+
+    // Take a buffer built in code; returns its id
+    int add(const sf::SoundBuffer& buffer, int priority = 0);
+
+    bool isValid(int id) const
+    {
+        return id >= 0 && id < static_cast<int>(m_effects.size());
+    }
+
+    const sf::SoundBuffer& getBuffer(int id) const
+    {
+        return m_effects[id].buffer;
+    }
+
+    int getPriority(int id) const
+    {
+        return m_effects[id].priority;
+    }
+
+private:
+    struct Effect
+    {
+        sf::SoundBuffer buffer;
+        int priority;
+    };
+
+    // A deque, because sf::Sound keeps a pointer to its buffer and adding
+    // effects must not move the ones already playing
+    std::deque<Effect> m_effects;
+};
@@ -0,0 +1,93 @@
+#include "VoicePool.h"
+
+VoicePool::VoicePool(const SoundBank& bank, int voiceCount)
+    : m_bank(bank), m_voices(voiceCount > 0 ? voiceCount : 0)
+{
+}
+
+bool VoicePool::play(int id, float volume, float pitch)
+{
+    if (m_voices.empty() || !m_bank.isValid(id))
+    {
+        return false;
+    }
+
+    // An idle voice, ideally one already holding this effect; else the least
+    // important sound, this same effect first on a tie, then the oldest
+    const sf::SoundBuffer* buffer = &m_bank.getBuffer(id);
+    Voice* idle = nullptr;
+    Voice* victim = nullptr;
+    for (Voice& voice : m_voices)
+    {
+        bool holdsBuffer = voice.sound.getBuffer() == buffer;
+        if (voice.sound.getStatus() == sf::Sound::Stopped)
+        {
+            if (holdsBuffer)
+            {
+                idle = &voice;
+                break;
+            }
+            if (!idle)
+            {
+                idle = &voice;
+            }
+            continue;
+        }
+
+        if (!victim || voice.priority < victim->priority)
+        {
+            victim = &voice;
+        }
+        else if (voice.priority == victim->priority)
+        {
+            bool victimHoldsBuffer = victim->sound.getBuffer() == buffer;
+            if (holdsBuffer != victimHoldsBuffer ? holdsBuffer : voice.started < victim->started)
+            {
+                victim = &voice;
+            }
+        }
+    }
+
+    int priority = m_bank.getPriority(id);
+    Voice* chosen = idle ? idle : victim;
+    if (!idle && victim->priority > priority)
+    {
+        return false;
+    }
+
+    chosen->sound.stop();
+
+    // setBuffer() registers the sound with its buffer, which allocates, so
+    // only switch buffers when the voice last played a different effect
+    if (chosen->sound.getBuffer() != buffer)
+    {
+        chosen->sound.setBuffer(*buffer);
+    }
+    chosen->sound.setVolume(volume);
+    chosen->sound.setPitch(pitch);
+    chosen->sound.play();
+    chosen->priority = priority;
+    chosen->started = ++m_playCount;
+    return true;
+}
+
+void VoicePool::stopAll()
+{
+    for (Voice& voice : m_voices)
+    {
+        voice.sound.stop();
+    }
+}
+
+int VoicePool::getActiveCount() const
+{
+    int active = 0;
+    for (const Voice& voice : m_voices)
+    {
+        if (voice.sound.getStatus() != sf::Sound::Stopped)
+        {
+            ++active;
+        }
+    }
+    return active;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <SFML/Audio/Sound.hpp>
+#include <vector>
+#include "SoundBank.h"
+
+// A fixed set of sf::Sound voices playing effects from a SoundBank.
+// Every voice (one OpenAL source each) is created up front, so playing an
+// effect never creates a source mid-game and the pool can never go past the
+// device's source limit, however many effects overlap.
+//
+// play() is fire and forget: it takes an idle voice, or steals the one
+// playing the lowest-priority effect (on a tie, one playing the same effect,
+// then the oldest) if that is no more important than the new effect.
+// Otherwise the new effect is dropped. Voices that already hold the effect's
+// buffer are preferred, since switching a voice's buffer allocates.
+class VoicePool
+{
+public:
+    // OpenAL implementations commonly allow 256 sources; stay well below
+    explicit VoicePool(const SoundBank& bank, int voiceCount = 16);
+
+    // Returns false if the effect was dropped or the id is not in the bank
+    bool play(int id, float volume = 100.f, float pitch = 1.f);
+
+    void stopAll();
+
+    // Voices playing right now
+    int getActiveCount() const;
+
+    int getVoiceCount() const
+    {
+        return static_cast<int>(m_voices.size());
+    }
+
+private:
+    struct Voice
+    {
+        sf::Sound sound;
+        int priority = 0;
+        unsigned long started = 0;  // play() count when it started, to find the oldest
+    };
+
+    const SoundBank& m_bank;
+    std::vector<Voice> m_voices;
+    unsigned long m_playCount = 0;
+};
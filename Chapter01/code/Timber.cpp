@@ -1,5 +1,7 @@
 // Include important C++ libraries here
 #include <SFML/Graphics.hpp>
+#include "Profiler.h"
+#include "ProfilerOverlay.h"
 
 // Make code easier to type with "using namespace"
 using namespace sf;
@@ -27,9 +29,17 @@ int main()
 	// Set the spriteBackground to cover the screen
 	spriteBackground.setPosition(0, 0);
 
+	// Where each frame's time goes; F3 shows the overlay, F4 saves a trace
+	Font font;
+	font.loadFromFile("fonts/KOMIKAP_.ttf");
+	Profiler profiler;
+	ProfilerOverlay profilerOverlay(profiler, font);
+	profilerOverlay.setPosition(1920 - 370, 20);
+	bool showProfiler = false;
 
 	while (window.isOpen())
 	{
+		profiler.beginFrame();
 
 		/*
 		****************************************
@@ -37,10 +47,26 @@ int main()
 		****************************************
 		*/
 
+		profiler.beginZone("input");
+		Event event;
+		while (window.pollEvent(event))
+		{
+			if (event.type == Event::KeyPressed && event.key.code == Keyboard::F3)
+			{
+				showProfiler = !showProfiler;
+			}
+
+			if (event.type == Event::KeyPressed && event.key.code == Keyboard::F4)
+			{
+				profiler.writeChromeTrace("profile.json");
+			}
+		}
+
 		if (Keyboard::isKeyPressed(Keyboard::Escape))
 		{
 			window.close();
 		}
+		profiler.endZone();
 
 		/*
 		****************************************
@@ -55,15 +81,30 @@ int main()
 		****************************************
 		*/
 
+		profiler.beginZone("draw");
+
 		// Clear everything from the last frame
 		window.clear();
 
 		// Draw our game scene here
 		window.draw(spriteBackground);
 
+		if (showProfiler)
+		{
+			window.draw(profilerOverlay);
+		}
+		profiler.endZone();
+
 		// Show everything we just drew
+		profiler.beginZone("display");
 		window.display();
+		profiler.endZone();
 
+		profiler.endFrame();
+		if (showProfiler)
+		{
+			profilerOverlay.update();
+		}
 
 	}
 
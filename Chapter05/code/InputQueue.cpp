@@ -0,0 +1,77 @@
+#include "InputQueue.h"
+
+#include <algorithm>
+
+using namespace sf;
+
+void InputQueue::push(const Event& event, Time now)
+{
+	if (event.type == Event::KeyPressed || event.type == Event::KeyReleased)
+	{
+		m_events.push_back({ event.key.code, event.type == Event::KeyPressed, now });
+	}
+}
+
+bool InputQueue::pop(Time upTo, InputEvent& event)
+{
+	if (m_events.empty() || m_events.front().time > upTo)
+	{
+		return false;
+	}
+
+	event = m_events.front();
+	m_events.pop_front();
+	return true;
+}
+
+void InputLatency::inputHandled(Time inputTime)
+{
+	if (!m_pending || inputTime < m_pendingTime)
+	{
+		m_pendingTime = inputTime;
+	}
+	m_pending = true;
+}
+
+void InputLatency::framePresented(Time now)
+{
+	if (!m_pending)
+	{
+		return;
+	}
+
+	m_samples[m_sampleCount % HISTORY] = now - m_pendingTime;
+	m_sampleCount++;
+	m_pending = false;
+}
+
+Time InputLatency::getLast() const
+{
+	return m_sampleCount > 0 ? m_samples[(m_sampleCount - 1) % HISTORY] : Time::Zero;
+}
+
+Time InputLatency::getAverage() const
+{
+	int count = std::min(m_sampleCount, HISTORY);
+	if (count == 0)
+	{
+		return Time::Zero;
+	}
+
+	Time total;
+	for (int i = 0; i < count; i++)
+	{
+		total += m_samples[i];
+	}
+	return total / (Int64)count;
+}
+
+Time InputLatency::getWorst() const
+{
+	Time worst;
+	for (int i = 0; i < std::min(m_sampleCount, HISTORY); i++)
+	{
+		worst = std::max(worst, m_samples[i]);
+	}
+	return worst;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <SFML/Window.hpp>
+#include <deque>
+
+// A key press or release, stamped with when the game saw it
+struct InputEvent
+{
+	sf::Keyboard::Key key;
+	bool pressed;
+	sf::Time time;
+};
+
+// Key events from pollEvent, kept in order with their timestamps until the
+// game logic takes them at a fixed-step boundary. Every press is seen
+// exactly once, however fast or slow frames are, unlike polling
+// isKeyPressed once per frame.
+//
+// The timestamp is when pollEvent returned the event; time the event spent
+// queued in the OS before that cannot be seen from here.
+class InputQueue
+{
+public:
+	// Keep key presses and releases; other events are ignored
+	void push(const sf::Event& event, sf::Time now);
+
+	// Take the oldest event if it happened at or before upTo
+	bool pop(sf::Time upTo, InputEvent& event);
+
+	bool empty() const
+	{
+		return m_events.empty();
+	}
+
+private:
+	std::deque<InputEvent> m_events;
+};
+
+// Input-to-photon latency: from an input's timestamp to the end of the first
+// display() that shows its effect. With vsync on, display() returns once
+// the frame has been handed to the screen; the monitor's own scan-out
+// delay is not included.
+class InputLatency
+{
+public:
+	// An input has changed the game; the earliest unshown one is kept
+	void inputHandled(sf::Time inputTime);
+
+	// Call right after window.display(); records a sample if an input was shown
+	void framePresented(sf::Time now);
+
+	// Samples recorded so far, to tell when the figures below change
+	int getSampleCount() const
+	{
+		return m_sampleCount;
+	}
+
+	sf::Time getLast() const;
+
+	// Average and worst over the most recent samples
+	sf::Time getAverage() const;
+	sf::Time getWorst() const;
+
+private:
+	static const int HISTORY = 32;
+
+	bool m_pending = false;
+	sf::Time m_pendingTime;
+	sf::Time m_samples[HISTORY];
+	int m_sampleCount = 0;
+};
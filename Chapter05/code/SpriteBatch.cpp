@@ -0,0 +1,70 @@
+#include "SpriteBatch.h"
+
+using namespace sf;
+
+void SpriteBatch::begin(RenderTarget& target)
+{
+	m_target = &target;
+	m_vertices.clear();
+	m_texture = nullptr;
+	m_batchCount = 0;
+	m_drawCallCount = 0;
+	m_spriteCount = 0;
+}
+
+void SpriteBatch::draw(const Sprite& sprite, const RenderStates& states)
+{
+	// Shaders can depend on per-draw uniforms, so those sprites go on their own
+	if (states.shader)
+	{
+		draw(static_cast<const Drawable&>(sprite), states);
+		return;
+	}
+
+	const Texture* texture = sprite.getTexture();
+	if (!m_vertices.empty() && (texture != m_texture || states.blendMode != m_blendMode))
+	{
+		flush();
+	}
+	m_texture = texture;
+	m_blendMode = states.blendMode;
+
+	// The same corners and texture coordinates Sprite itself would draw,
+	// moved to where the sprite is since the vertices share one transform
+	Transform transform = states.transform * sprite.getTransform();
+	FloatRect bounds = sprite.getLocalBounds();
+	IntRect rect = sprite.getTextureRect();
+	float left = (float)rect.left;
+	float right = left + rect.width;
+	float top = (float)rect.top;
+	float bottom = top + rect.height;
+	Color color = sprite.getColor();
+
+	m_vertices.push_back(Vertex(transform.transformPoint(0, 0), color, Vector2f(left, top)));
+	m_vertices.push_back(Vertex(transform.transformPoint(bounds.width, 0), color, Vector2f(right, top)));
+	m_vertices.push_back(Vertex(transform.transformPoint(bounds.width, bounds.height), color, Vector2f(right, bottom)));
+	m_vertices.push_back(Vertex(transform.transformPoint(0, bounds.height), color, Vector2f(left, bottom)));
+	m_spriteCount++;
+}
+
+void SpriteBatch::draw(const Drawable& drawable, const RenderStates& states)
+{
+	flush();
+	m_target->draw(drawable, states);
+	m_drawCallCount++;
+}
+
+void SpriteBatch::flush()
+{
+	if (m_vertices.empty())
+	{
+		return;
+	}
+
+	RenderStates states(m_blendMode);
+	states.texture = m_texture;
+	m_target->draw(&m_vertices[0], m_vertices.size(), Quads, states);
+	m_vertices.clear();
+	m_batchCount++;
+	m_drawCallCount++;
+}
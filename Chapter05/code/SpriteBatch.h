@@ -0,0 +1,58 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// Collects sprites into one vertex stream and draws them with a single
+// RenderTarget::draw call for as long as they share a texture and blend
+// mode; a change of either flushes the batch so far. Anything else drawn
+// through the batch (text, shapes) flushes first, so drawing order is kept.
+//
+// Usage per frame: begin(window), draw(...) everything, end(), then read
+// the counters to see what the frame cost.
+class SpriteBatch
+{
+public:
+	// Start a frame on target and reset the counters
+	void begin(sf::RenderTarget& target);
+
+	// Queue a sprite; states.texture is ignored (the sprite's own is used)
+	void draw(const sf::Sprite& sprite, const sf::RenderStates& states = sf::RenderStates::Default);
+
+	// Flush, then draw a non-sprite drawable directly
+	void draw(const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default);
+
+	// Draw whatever is queued
+	void flush();
+
+	void end()
+	{
+		flush();
+	}
+
+	// Sprite batches flushed since begin()
+	int getBatchCount() const
+	{
+		return m_batchCount;
+	}
+
+	// RenderTarget draw calls since begin(), batches and direct draws together
+	int getDrawCallCount() const
+	{
+		return m_drawCallCount;
+	}
+
+	int getSpriteCount() const
+	{
+		return m_spriteCount;
+	}
+
+private:
+	sf::RenderTarget* m_target = nullptr;
+	std::vector<sf::Vertex> m_vertices;
+	const sf::Texture* m_texture = nullptr;
+	sf::BlendMode m_blendMode;
+	int m_batchCount = 0;
+	int m_drawCallCount = 0;
+	int m_spriteCount = 0;
+};
@@ -1,7 +1,16 @@
 // Include important C++ libraries here
 #include <sstream>
+#include <iostream>
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
+#include "FixedTimestep.h"
+#include "InputQueue.h"
+#include "Profiler.h"
+#include "ProfilerOverlay.h"
+#include "SoundBank.h"
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+#include "VoicePool.h"
 
 // Make code easier to type with "using namespace"
 using namespace sf;
@@ -25,33 +34,41 @@ int main()
 	// Create and open a window for the game
 	RenderWindow window(vm, "Timber!!!", Style::Fullscreen);
 
-	// Create a texture to hold a graphic on the GPU
-	Texture textureBackground;
-
-	// Load a graphic into the texture
-	textureBackground.loadFromFile("graphics/background.png");
+	// Load every graphic into one texture on the GPU, so the whole
+	// scene can be drawn as a single batch
+	TextureAtlas atlas;
+	SpriteHandle atlasBackground = atlas.add("graphics/background.png");
+	SpriteHandle atlasTree = atlas.add("graphics/tree.png");
+	SpriteHandle atlasBee = atlas.add("graphics/bee.png");
+	SpriteHandle atlasCloud = atlas.add("graphics/cloud.png");
+	SpriteHandle atlasBranch = atlas.add("graphics/branch.png");
+	SpriteHandle atlasPlayer = atlas.add("graphics/player.png");
+	SpriteHandle atlasRIP = atlas.add("graphics/rip.png");
+	SpriteHandle atlasAxe = atlas.add("graphics/axe.png");
+	SpriteHandle atlasLog = atlas.add("graphics/log.png");
+	if (!atlas.build())
+	{
+		std::cerr << "The graphics do not fit in a texture on this GPU" << std::endl;
+		return -1;
+	}
 
 	// Create a sprite
 	Sprite spriteBackground;
 
-	// Attach the texture to the sprite
-	spriteBackground.setTexture(textureBackground);
+	// Attach the background's part of the atlas to the sprite
+	atlas.apply(spriteBackground, atlasBackground);
 
 	// Set the spriteBackground to cover the screen
 	spriteBackground.setPosition(0, 0);
 
 	// Make a tree sprite
-	Texture textureTree;
-	textureTree.loadFromFile("graphics/tree.png");
 	Sprite spriteTree;
-	spriteTree.setTexture(textureTree);
+	atlas.apply(spriteTree, atlasTree);
 	spriteTree.setPosition(810, 0);
 
 	// Prepare the bee
-	Texture textureBee;
-	textureBee.loadFromFile("graphics/bee.png");
 	Sprite spriteBee;
-	spriteBee.setTexture(textureBee);
+	atlas.apply(spriteBee, atlasBee);
 	spriteBee.setPosition(0, 800);
 
 	// Is the bee currently moving?
@@ -60,19 +77,15 @@ int main()
 	// How fast can the bee fly
 	float beeSpeed = 0.0f;
 
-	// make 3 cloud sprites from 1 texture
-	Texture textureCloud;
+	// make 3 cloud sprites from 1 image
 
-	// Load 1 new texture
-	textureCloud.loadFromFile("graphics/cloud.png");
-
-	// 3 New sprites withe the same texture
+	// 3 New sprites withe the same image
 	Sprite spriteCloud1;
 	Sprite spriteCloud2;
 	Sprite spriteCloud3;
-	spriteCloud1.setTexture(textureCloud);
-	spriteCloud2.setTexture(textureCloud);
-	spriteCloud3.setTexture(textureCloud);
+	atlas.apply(spriteCloud1, atlasCloud);
+	atlas.apply(spriteCloud2, atlasCloud);
+	atlas.apply(spriteCloud3, atlasCloud);
 
 	// Position the clouds off screen
 	spriteCloud1.setPosition(0, 0);
@@ -89,8 +102,21 @@ int main()
 	float cloud2Speed = 0.0f;
 	float cloud3Speed = 0.0f;
 
-	// Variables to control time itself
-	Clock clock;
+	// Variables to control time itself; the clock is never restarted, so it
+	// timestamps input and frames on one timeline
+	Clock inputClock;
+	Time lastFrameTime;
+
+	// The scene is updated in fixed steps of 1/120 s whatever the frame rate,
+	// and drawn part of the way between the last two steps
+	const Time TIME_STEP = seconds(1.0f / 120.0f);
+	const int MAX_STEPS_PER_FRAME = 8;
+	FixedTimestep timestep(TIME_STEP, MAX_STEPS_PER_FRAME);
+	Vector2f beePrevious;
+	Vector2f cloud1Previous;
+	Vector2f cloud2Previous;
+	Vector2f cloud3Previous;
+	Vector2f logPrevious;
 	// Time bar
 	RectangleShape timeBar;
 	float timeBarStartWidth = 400;
@@ -143,13 +169,27 @@ int main()
 
 	scoreText.setPosition(20, 20);
 
-	// Prepare 5 branches
-	Texture textureBranch;
-	textureBranch.loadFromFile("graphics/branch.png");
+	// What the last frame cost to draw
+	SpriteBatch batch;
+	Text statsText;
+	statsText.setFont(font);
+	statsText.setCharacterSize(20);
+	statsText.setFillColor(Color::White);
+	statsText.setPosition(20, 1040);
+	int shownBatches = -1;
+	int shownDrawCalls = -1;
+	int shownLatencySamples = -1;
+
+	// Where each frame's time goes; F3 shows the overlay, F4 saves a trace
+	Profiler profiler;
+	ProfilerOverlay profilerOverlay(profiler, font);
+	profilerOverlay.setPosition(1920 - 370, 20);
+	bool showProfiler = false;
 
+	// Prepare 5 branches
 	// Set the texture for each branch sprite
 	for (int i = 0; i < NUM_BRANCHES; i++) {
-		branches[i].setTexture(textureBranch);
+		atlas.apply(branches[i], atlasBranch);
 		branches[i].setPosition(-2000, -2000);
 
 		// Set the sprite's origin to dead center
@@ -158,27 +198,21 @@ int main()
 	}
 
 	// Prepare the player
-	Texture texturePlayer;
-	texturePlayer.loadFromFile("graphics/player.png");
 	Sprite spritePlayer;
-	spritePlayer.setTexture(texturePlayer);
+	atlas.apply(spritePlayer, atlasPlayer);
 	spritePlayer.setPosition(580, 720);
 
 	// The player starts on the left
 	side playerSide = side::LEFT;
 
 	// Prepare the gravestone
-	Texture textureRIP;
-	textureRIP.loadFromFile("graphics/rip.png");
 	Sprite spriteRIP;
-	spriteRIP.setTexture(textureRIP);
+	atlas.apply(spriteRIP, atlasRIP);
 	spriteRIP.setPosition(600, 860);
 
 	// Prepare the axe
-	Texture textureAxe;
-	textureAxe.loadFromFile("graphics/axe.png");
 	Sprite spriteAxe;
-	spriteAxe.setTexture(textureAxe);
+	atlas.apply(spriteAxe, atlasAxe);
 	spriteAxe.setPosition(700, 830);
 
 	// Line the axe up with the tree
@@ -186,10 +220,8 @@ int main()
 	const float AXE_POSITION_RIGHT = 1075;
 
 	// Prepare the flying log
-	Texture textureLog;
-	textureLog.loadFromFile("graphics/log.png");
 	Sprite spriteLog;
-	spriteLog.setTexture(textureLog);
+	atlas.apply(spriteLog, atlasLog);
 	spriteLog.setPosition(810, 720);
 
 	// Some other useful log related variables
@@ -199,155 +231,167 @@ int main()
 	
 	// Control the player input
 	bool acceptInput = false;
+	InputQueue inputQueue;
+	InputLatency latency;
+	window.setKeyRepeatEnabled(false);
 
-	// Prepare the sound
-	SoundBuffer chopBuffer;
-	chopBuffer.loadFromFile("sound/chop.wav");
-	Sound chop;
-	chop.setBuffer(chopBuffer);
+	// With vsync, display() returns once the frame is on its way to the
+	// screen, so the latency measured after it is the one players see
+	window.setVerticalSyncEnabled(true);
 
-	SoundBuffer deathBuffer;
-	deathBuffer.loadFromFile("sound/death.wav");
-	Sound death;
-	death.setBuffer(deathBuffer);
+	// Prepare the sound: each effect is loaded once, and a small pool of
+	// voices plays them, so quick chops overlap instead of cutting each
+	// other off. The end-of-game sounds win over chops if voices run out.
+	SoundBank soundBank;
+	int chopSound = soundBank.load("sound/chop.wav", 0);
+	int deathSound = soundBank.load("sound/death.wav", 1);
 
 	// Out of time
-	SoundBuffer ootBuffer;
-	ootBuffer.loadFromFile("sound/out_of_time.wav");
-	Sound outOfTime;
-	outOfTime.setBuffer(ootBuffer);
+	int outOfTimeSound = soundBank.load("sound/out_of_time.wav", 1);
+
+	VoicePool sounds(soundBank, 8);
 	
-	while (window.isOpen())
+	// Apply the queued key events that happened by upTo, oldest first
+	auto handleInput = [&](Time upTo)
 	{
-		// score ++;
-		Event event;
-		while (window.pollEvent(event))
+		InputEvent input;
+		while (inputQueue.pop(upTo, input))
 		{
-			
-
-			if (event.type == Event::KeyReleased && !paused)
+			if (input.pressed && input.key == Keyboard::Escape)
 			{
-				// Listen for key presses again
-				acceptInput = true;
-
-				// hide the axe
-				spriteAxe.setPosition(2000,
-					spriteAxe.getPosition().y);
+				window.close();
 			}
 
-		}
-
-		/*
-		****************************************
-		Handle the players input
-		****************************************
-		*/
+			if (input.pressed && input.key == Keyboard::F3)
+			{
+				showProfiler = !showProfiler;
+			}
 
-		if (Keyboard::isKeyPressed(Keyboard::Escape))
-		{
-			window.close();
-		}
+			if (input.pressed && input.key == Keyboard::F4)
+			{
+				profiler.writeChromeTrace("profile.json");
+			}
 
-		// Start the game
-		if (Keyboard::isKeyPressed(Keyboard::Return))
-		{
-			paused = false;
+			// Start the game
+			if (input.pressed && input.key == Keyboard::Return)
+			{
+				paused = false;
 
-			// Reset the time and the score
-			score = 0;
-			timeRemaining = 6;
+				// Reset the time and the score
+				score = 0;
+				timeRemaining = 6;
 
-			// Make all the branches disappear
-			for (int i = 1; i < NUM_BRANCHES; i++)
-			{
-				branchPositions[i] = side::NONE;
-			}
+				// Make all the branches disappear
+				for (int i = 1; i < NUM_BRANCHES; i++)
+				{
+					branchPositions[i] = side::NONE;
+				}
 
-			// Make sure the gravestone is hidden
-			spriteRIP.setPosition(675, 2000);
+				// Make sure the gravestone is hidden
+				spriteRIP.setPosition(675, 2000);
 
-			// Move the player into position
-			spritePlayer.setPosition(580, 720);
+				// Move the player into position
+				spritePlayer.setPosition(580, 720);
 
-			acceptInput = true;
+				acceptInput = true;
+				latency.inputHandled(input.time);
 
 
-		}
+			}
 
-		// Wrap the player controls to
-		// Make sure we are accepting input
-		if (acceptInput)
-		{
-			// More code here next...
-			// First handle pressing the right cursor key
-			if (Keyboard::isKeyPressed(Keyboard::Right))
+			// Wrap the player controls to
+			// Make sure we are accepting input
+			// Each press chops once: key repeat is off, so holding a key does nothing more
+			if (acceptInput && input.pressed)
 			{
-				// Make sure the player is on the right
-				playerSide = side::RIGHT;
+				if (input.key == Keyboard::Right)
+				{
+					// Make sure the player is on the right
+					playerSide = side::RIGHT;
 
-				score++;
+					score++;
 
-				// Add to the amount of time remaining
-				timeRemaining += (2 / score) + .15;
+					// Add to the amount of time remaining
+					timeRemaining += (2 / score) + .15;
 
-				spriteAxe.setPosition(AXE_POSITION_RIGHT,
-					spriteAxe.getPosition().y);
+					spriteAxe.setPosition(AXE_POSITION_RIGHT,
+						spriteAxe.getPosition().y);
 
 				
 
-				spritePlayer.setPosition(1200, 720);
-
-				// update the branches
-				updateBranches(score);
+					spritePlayer.setPosition(1200, 720);
 
-				// set the log flying to the left
-				spriteLog.setPosition(810, 720);
-				logSpeedX = -5000;
-				logActive = true;
+					// update the branches
+					updateBranches(score);
 
+					// set the log flying to the left
+					spriteLog.setPosition(810, 720);
+					logSpeedX = -5000;
+					logActive = true;
 
-				acceptInput = false;
-
-				// Play a chop sound
-				chop.play();
 
-			}
+					// Play a chop sound
+					sounds.play(chopSound);
+					latency.inputHandled(input.time);
 
-			// Handle the left cursor key
-			if (Keyboard::isKeyPressed(Keyboard::Left))
-			{
-				// Make sure the player is on the left
-				playerSide = side::LEFT;
+				}
+				// Handle the left cursor key
+				else if (input.key == Keyboard::Left)
+				{
+					// Make sure the player is on the left
+					playerSide = side::LEFT;
 
-				score++;
+					score++;
 
-				// Add to the amount of time remaining
-				timeRemaining += (2 / score) + .15;
+					// Add to the amount of time remaining
+					timeRemaining += (2 / score) + .15;
 
-				spriteAxe.setPosition(AXE_POSITION_LEFT,
-					spriteAxe.getPosition().y);
+					spriteAxe.setPosition(AXE_POSITION_LEFT,
+						spriteAxe.getPosition().y);
 
 
-				spritePlayer.setPosition(580, 720);
+					spritePlayer.setPosition(580, 720);
 
-				// update the branches
-				updateBranches(score);
+					// update the branches
+					updateBranches(score);
 
-				// set the log flying
-				spriteLog.setPosition(810, 720);
-				logSpeedX = 5000;
-				logActive = true;
+					// set the log flying
+					spriteLog.setPosition(810, 720);
+					logSpeedX = 5000;
+					logActive = true;
 
 
-				acceptInput = false;
+					// Play a chop sound
+					sounds.play(chopSound);
+					latency.inputHandled(input.time);
 
-				// Play a chop sound
-				chop.play();
+				}
+			}
 
+			if (!input.pressed && !paused &&
+				(input.key == Keyboard::Left || input.key == Keyboard::Right))
+			{
+				// hide the axe
+				spriteAxe.setPosition(2000,
+					spriteAxe.getPosition().y);
 			}
+		}
+	};
 
+	while (window.isOpen())
+	{
+		// score ++;
+		profiler.beginFrame();
 
+		// Queue key events with the time they arrived; the game logic
+		// takes them at the start of the fixed step they fall before
+		profiler.beginZone("input");
+		Event event;
+		while (window.pollEvent(event))
+		{
+			inputQueue.push(event, inputClock.getElapsedTime());
 		}
+		profiler.endZone();
 
 
 		/*
@@ -355,11 +399,40 @@ int main()
 		Update the scene
 		****************************************
 		*/
-		if (!paused)
+		// Measure time; none is owed while the game is paused, so
+		// starting again does not run one huge step
+		profiler.beginZone("update");
+		Time now = inputClock.getElapsedTime();
+		Time frameTime = now - lastFrameTime;
+		lastFrameTime = now;
+		if (paused)
+		{
+			timestep.reset();
+		}
+		else
 		{
+			timestep.addTime(frameTime);
+		}
 
-			// Measure time
-			Time dt = clock.restart();
+		// While paused no steps run, so input is handled straight away
+		if (paused)
+		{
+			handleInput(now);
+		}
+
+		while (!paused && timestep.isStepDue())
+		{
+			// Input from before this step began is applied first
+			handleInput(now - timestep.getBacklog());
+			timestep.takeStep();
+			Time dt = timestep.getStep();
+
+			// Remember where the moving sprites were
+			beePrevious = spriteBee.getPosition();
+			cloud1Previous = spriteCloud1.getPosition();
+			cloud2Previous = spriteCloud2.getPosition();
+			cloud3Previous = spriteCloud3.getPosition();
+			logPrevious = spriteLog.getPosition();
 
 			// Subtract from the amount of time remaining
 			timeRemaining -= dt.asSeconds();
@@ -386,7 +459,7 @@ int main()
 				messageText.setPosition(1920 / 2.0f, 1080 / 2.0f);
 
 				// Play the out of time sound
-				outOfTime.play();
+				sounds.play(outOfTimeSound);
 
 
 			}
@@ -599,13 +672,14 @@ int main()
 					1080 / 2.0f);
 
 				// Play the death sound
-				death.play();
+				sounds.play(deathSound);
 
 
 			}
 
 
-		}// End if(!paused)
+		}// End while(!paused)
+		profiler.endZone();
 
 		 /*
 		 ****************************************
@@ -613,55 +687,95 @@ int main()
 		 ****************************************
 		 */
 
+		 // How far into the next step this frame is; paused scenes are drawn as they are
+		float alpha = paused ? 1.0f : timestep.getAlpha();
+
 		 // Clear everything from the last frame
+		profiler.beginZone("draw");
 		window.clear();
 
+		// Sprites sharing the atlas are queued and drawn together
+		batch.begin(window);
+
 		// Draw our game scene here
-		window.draw(spriteBackground);
+		batch.draw(spriteBackground);
 
 		// Draw the clouds
-		window.draw(spriteCloud1);
-		window.draw(spriteCloud2);
-		window.draw(spriteCloud3);
+		batch.draw(spriteCloud1, interpolate(cloud1Previous, spriteCloud1.getPosition(), alpha));
+		batch.draw(spriteCloud2, interpolate(cloud2Previous, spriteCloud2.getPosition(), alpha));
+		batch.draw(spriteCloud3, interpolate(cloud3Previous, spriteCloud3.getPosition(), alpha));
 
 		// Draw the branches
 		for (int i = 0; i < NUM_BRANCHES; i++) {
-			window.draw(branches[i]);
+			batch.draw(branches[i]);
 		}
 
 		// Draw the tree
-		window.draw(spriteTree);
+		batch.draw(spriteTree);
 		// Draw the player
-		window.draw(spritePlayer);
+		batch.draw(spritePlayer);
 
 		// Draw the axe
-		window.draw(spriteAxe);
+		batch.draw(spriteAxe);
 
 		// Draraw the flying log
-		window.draw(spriteLog);
+		batch.draw(spriteLog, interpolate(logPrevious, spriteLog.getPosition(), alpha));
 
 		// Draw the gravestone
-		window.draw(spriteRIP);
+		batch.draw(spriteRIP);
 
 
 		// Drawraw the bee
-		window.draw(spriteBee);
+		batch.draw(spriteBee, interpolate(beePrevious, spriteBee.getPosition(), alpha));
 
 		// Draw the score
-		window.draw(scoreText);
+		batch.draw(scoreText);
 
 		// Draw the timebar
-		window.draw(timeBar);
+		batch.draw(timeBar);
 
 
 		if (paused)
 		{
 			// Draw our message
-			window.draw(messageText);
+			batch.draw(messageText);
 		}
 
+		// Draw the cost of the previous frame
+		batch.draw(statsText);
+		if (showProfiler)
+		{
+			batch.draw(profilerOverlay);
+		}
+		batch.end();
+
+		if (batch.getBatchCount() != shownBatches || batch.getDrawCallCount() != shownDrawCalls ||
+			latency.getSampleCount() != shownLatencySamples)
+		{
+			shownBatches = batch.getBatchCount();
+			shownDrawCalls = batch.getDrawCallCount();
+			shownLatencySamples = latency.getSampleCount();
+			std::stringstream ss;
+			ss << "Sprites " << batch.getSpriteCount() << ", batches " << shownBatches << ", draw calls " << shownDrawCalls
+				<< ", input latency " << latency.getLast().asMicroseconds() / 1000.0f << " ms (avg "
+				<< latency.getAverage().asMicroseconds() / 1000.0f << ", worst "
+				<< latency.getWorst().asMicroseconds() / 1000.0f << ")";
+			statsText.setString(ss.str());
+		}
+
+		profiler.endZone();
+
 		// Show everything we just drew
+		profiler.beginZone("display");
 		window.display();
+		latency.framePresented(inputClock.getElapsedTime());
+		profiler.endZone();
+
+		profiler.endFrame();
+		if (showProfiler)
+		{
+			profilerOverlay.update();
+		}
 
 
 	}
@@ -0,0 +1,59 @@
+#include "ECE_AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+#ifndef NDEBUG
+
+namespace
+{
+    atomic<size_t> allocationCount(0);
+}
+
+// Replacing the plain forms is enough: the array and nothrow forms call these
+void* operator new(size_t size)
+{
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    if (void* memory = malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    free(memory);
+}
+
+bool ECE_AllocationCounter::isEnabled()
+{
+    return true;
+}
+
+size_t ECE_AllocationCounter::getCount()
+{
+    return allocationCount.load(memory_order_relaxed);
+}
+
+#else
+
+bool ECE_AllocationCounter::isEnabled()
+{
+    return false;
+}
+
+size_t ECE_AllocationCounter::getCount()
+{
+    return 0;
+}
+
+#endif
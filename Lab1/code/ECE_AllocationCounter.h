@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+// Counts heap allocations made through the global operator new, so a debug
+// build can report any frame that touches the heap. Allocation spikes show up
+// as hitches on slow machines, and the frame loop is meant to allocate nothing
+// once the game is running. Release builds (NDEBUG) leave operator new alone
+// and the counter stays at 0.
+class ECE_AllocationCounter
+{
+public:
+    static bool isEnabled();
+
+    // Allocations since the program started
+    static std::size_t getCount();
+
+    // Start counting a frame
+    void beginFrame()
+    {
+        frameStart = getCount();
+    }
+
+    // Allocations since beginFrame()
+    std::size_t getFrameCount() const
+    {
+        return getCount() - frameStart;
+    }
+
+private:
+    std::size_t frameStart = 0;
+};
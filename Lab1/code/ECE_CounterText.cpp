@@ -0,0 +1,50 @@
+#include "ECE_CounterText.h"
+
+#include <charconv>
+
+using namespace sf;
+using namespace std;
+
+namespace
+{
+    // Every character a number can show, as long as the longest int
+    const char* const NUMBER_CHARACTERS = "-0123456789";
+}
+
+ECE_CounterText::ECE_CounterText(const String& label, const Font& font, unsigned int characterSize, int value)
+    : text("", font, characterSize), labelLength(label.getSize()), value(value)
+{
+    // Reserve both strings for the longest number before writing the real one
+    buffer = label + NUMBER_CHARACTERS;
+    text.setString(buffer);
+    format();
+}
+
+void ECE_CounterText::warmUp()
+{
+    String widest = buffer.substring(0, labelLength) + NUMBER_CHARACTERS;
+    text.setString(widest);
+    text.getLocalBounds();
+    text.setString(buffer);
+}
+
+void ECE_CounterText::setValue(int newValue)
+{
+    if (newValue != value)
+    {
+        value = newValue;
+        format();
+    }
+}
+
+void ECE_CounterText::format()
+{
+    char digits[16];
+    to_chars_result result = to_chars(digits, digits + sizeof(digits), value);
+    buffer.erase(labelLength, buffer.getSize() - labelLength);
+    for (const char* digit = digits; digit != result.ptr; ++digit)
+    {
+        buffer += String(static_cast<Uint32>(*digit));
+    }
+    text.setString(buffer);
+}
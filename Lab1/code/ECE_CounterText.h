@@ -0,0 +1,38 @@
+#pragma once
+
+#include <SFML/Graphics/Text.hpp>
+#include <cstddef>
+
+// A "Label: 123" text whose number changes during play. The label and number
+// are written into a string that keeps the capacity of the longest number, and
+// the text's own copy, its vertices and the digit glyphs are sized up front,
+// so changing the number never touches the heap.
+class ECE_CounterText
+{
+public:
+    ECE_CounterText(const sf::String& label, const sf::Font& font, unsigned int characterSize, int value);
+
+    // Render every digit glyph and size the vertices for the longest number.
+    // Glyphs are rendered into the font's texture, so this needs a window.
+    void warmUp();
+
+    void setValue(int value);
+
+    int getValue() const
+    {
+        return value;
+    }
+
+    sf::Text& getText()
+    {
+        return text;
+    }
+
+private:
+    void format();
+
+    sf::Text text;
+    sf::String buffer;
+    std::size_t labelLength;
+    int value;
+};
@@ -0,0 +1,158 @@
+#include "ECE_EntityStore.h"
+#include "FixedTimestep.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace sf;
+using namespace std;
+
+void ECE_EntityStore::reserve(int capacity)
+{
+    positions.reserve(capacity);
+    previousPositions.reserve(capacity);
+    sizes.reserve(capacity);
+    health.reserve(capacity);
+    sprites.reserve(capacity);
+    flipped.reserve(capacity);
+    slotOf.reserve(capacity);
+    indexOfSlot.reserve(capacity);
+    generations.reserve(capacity);
+    freeSlots.reserve(capacity);
+
+    // VertexArray has no reserve, but shrinking it keeps the storage
+    size_t used = vertices.getVertexCount();
+    vertices.resize(max<size_t>(used, capacity * 4));
+    vertices.resize(used);
+}
+
+ECE_EntityHandle ECE_EntityStore::create(Vector2f position, SpriteHandle sprite, int health)
+{
+    uint32_t slot;
+    if (freeSlots.empty())
+    {
+        slot = static_cast<uint32_t>(generations.size());
+        generations.push_back(0);
+        indexOfSlot.push_back(-1);
+    }
+    else
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+
+    const IntRect& rect = atlas.getRect(sprite);
+    indexOfSlot[slot] = size();
+    slotOf.push_back(slot);
+    positions.push_back(position);
+    previousPositions.push_back(position);
+    sizes.push_back(Vector2f(static_cast<float>(rect.width), static_cast<float>(rect.height)));
+    this->health.push_back(health);
+    sprites.push_back(sprite);
+    flipped.push_back(0);
+    return {slot, generations[slot]};
+}
+
+int ECE_EntityStore::indexOf(ECE_EntityHandle handle) const
+{
+    if (handle.slot >= generations.size() || generations[handle.slot] != handle.generation)
+    {
+        return -1;
+    }
+    return indexOfSlot[handle.slot];
+}
+
+void ECE_EntityStore::removeDead()
+{
+    int kept = 0;
+    for (int i = 0; i < size(); ++i)
+    {
+        uint32_t slot = slotOf[i];
+        if (health[i] <= 0)
+        {
+            // Retire the slot; the new generation invalidates outstanding handles
+            ++generations[slot];
+            indexOfSlot[slot] = -1;
+            freeSlots.push_back(slot);
+            continue;
+        }
+
+        if (kept != i)
+        {
+            slotOf[kept] = slot;
+            positions[kept] = positions[i];
+            previousPositions[kept] = previousPositions[i];
+            sizes[kept] = sizes[i];
+            health[kept] = health[i];
+            sprites[kept] = sprites[i];
+            flipped[kept] = flipped[i];
+            indexOfSlot[slot] = kept;
+        }
+        ++kept;
+    }
+
+    slotOf.resize(kept);
+    positions.resize(kept);
+    previousPositions.resize(kept);
+    sizes.resize(kept);
+    health.resize(kept);
+    sprites.resize(kept);
+    flipped.resize(kept);
+}
+
+void ECE_EntityStore::clear()
+{
+    for (int i = 0; i < size(); ++i)
+    {
+        health[i] = 0;
+    }
+    removeDead();
+}
+
+void ECE_EntityStore::swapEntries(int a, int b)
+{
+    swap(slotOf[a], slotOf[b]);
+    swap(positions[a], positions[b]);
+    swap(previousPositions[a], previousPositions[b]);
+    swap(sizes[a], sizes[b]);
+    swap(health[a], health[b]);
+    swap(sprites[a], sprites[b]);
+    swap(flipped[a], flipped[b]);
+    indexOfSlot[slotOf[a]] = a;
+    indexOfSlot[slotOf[b]] = b;
+}
+
+void ECE_EntityStore::setSprite(int index, SpriteHandle sprite)
+{
+    const IntRect& rect = atlas.getRect(sprite);
+    sprites[index] = sprite;
+    sizes[index] = Vector2f(static_cast<float>(rect.width), static_cast<float>(rect.height));
+}
+
+void ECE_EntityStore::draw(RenderTarget& target, float alpha)
+{
+    vertices.resize(positions.size() * 4);
+    for (int i = 0; i < size(); ++i)
+    {
+        Vector2f topLeft = positions[i] + interpolationOffset(previousPositions[i], positions[i], alpha);
+        Vector2f bottomRight = topLeft + sizes[i];
+        const IntRect& rect = atlas.getRect(sprites[i]);
+        float left = static_cast<float>(rect.left);
+        float top = static_cast<float>(rect.top);
+        float right = left + rect.width;
+        float bottom = top + rect.height;
+        if (flipped[i])
+        {
+            swap(left, right);
+            swap(top, bottom);
+        }
+
+        Vertex* quad = &vertices[i * 4];
+        quad[0] = Vertex(topLeft, Vector2f(left, top));
+        quad[1] = Vertex(Vector2f(bottomRight.x, topLeft.y), Vector2f(right, top));
+        quad[2] = Vertex(bottomRight, Vector2f(right, bottom));
+        quad[3] = Vertex(Vector2f(topLeft.x, bottomRight.y), Vector2f(left, bottom));
+    }
+
+    target.draw(vertices, &atlas.getTexture());
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+#include "TextureAtlas.h"
+
+// Stable reference to an entity in an ECE_EntityStore. The slot is reused
+// once its entity is removed, and the generation then moves on, so an old
+// handle to a removed entity never resolves to whatever took its place.
+struct ECE_EntityHandle
+{
+    std::uint32_t slot = 0;
+    std::uint32_t generation = 0;
+};
+
+// Entities of one kind kept as parallel arrays (structure of arrays) rather
+// than one sf::Sprite each: positions, sizes, health and atlas images sit in
+// contiguous vectors, so updates and collision checks are linear sweeps, and
+// the whole store is drawn from the shared atlas in a single draw call.
+//
+// Dense index i is the i-th live entity; it changes when entities are
+// removed, so anything held across steps should be an ECE_EntityHandle.
+class ECE_EntityStore
+{
+public:
+    explicit ECE_EntityStore(const TextureAtlas& atlas) : atlas(atlas)
+    {
+    }
+
+    // Make room for capacity entities up front, so creating and removing
+    // entities up to that many never touches the heap again
+    void reserve(int capacity);
+
+    int capacity() const
+    {
+        return static_cast<int>(positions.capacity());
+    }
+
+    // Add an entity at position (top-left), sized to its atlas image
+    ECE_EntityHandle create(sf::Vector2f position, SpriteHandle sprite, int health);
+
+    bool isAlive(ECE_EntityHandle handle) const
+    {
+        return indexOf(handle) >= 0;
+    }
+
+    // Dense index of a live entity, or -1 if the handle is stale
+    int indexOf(ECE_EntityHandle handle) const;
+
+    ECE_EntityHandle handleAt(int index) const
+    {
+        return {slotOf[index], generations[slotOf[index]]};
+    }
+
+    // Drop every entity whose health is 0 or less, keeping the rest in order
+    void removeDead();
+
+    void clear();
+
+    // Exchange two entities' places in the dense order; handles follow them
+    void swapEntries(int a, int b);
+
+    // Record where everything is before a simulation step, for interpolation
+    void beginStep()
+    {
+        previousPositions = positions;
+    }
+
+    void setSprite(int index, SpriteHandle sprite);
+
+    sf::FloatRect getBounds(int index) const
+    {
+        return sf::FloatRect(positions[index], sizes[index]);
+    }
+
+    int size() const
+    {
+        return static_cast<int>(positions.size());
+    }
+
+    // Draw every entity alpha of the way from its previous to its current position
+    void draw(sf::RenderTarget& target, float alpha);
+
+    // The columns, indexed by dense index
+    std::vector<sf::Vector2f> positions;
+    std::vector<sf::Vector2f> previousPositions;
+    std::vector<sf::Vector2f> sizes;
+    std::vector<int> health;
+    std::vector<SpriteHandle> sprites;
+    std::vector<char> flipped;  // drawn turned half a circle
+
+private:
+    const TextureAtlas& atlas;
+    std::vector<std::uint32_t> slotOf;       // dense index -> slot
+    std::vector<int> indexOfSlot;            // slot -> dense index, -1 when free
+    std::vector<std::uint32_t> generations;  // per slot
+    std::vector<std::uint32_t> freeSlots;
+    sf::VertexArray vertices{sf::Quads};
+};
@@ -0,0 +1,121 @@
+#include "ECE_Replay.h"
+
+#include <algorithm>
+#include <fstream>
+
+using namespace std;
+
+namespace
+{
+    const char MAGIC[4] = {'E', 'C', 'E', 'R'};
+    const unsigned char VERSION = 1;
+
+    // Seven bits per byte, high bit set on all but the last
+    void writeVarint(ostream& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.put(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.put(static_cast<char>(value));
+    }
+
+    bool readVarint(istream& in, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            int byte = in.get();
+            if (byte == EOF)
+            {
+                return false;
+            }
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+bool ECE_Replay::save(const string& path) const
+{
+    ofstream out(path, ios::binary);
+    if (!out)
+    {
+        return false;
+    }
+
+    out.write(MAGIC, sizeof(MAGIC));
+    out.put(static_cast<char>(VERSION));
+    for (int i = 0; i < 4; ++i)
+    {
+        out.put(static_cast<char>((seed >> (8 * i)) & 0xff));
+    }
+    writeVarint(out, inputs.size());
+
+    // Keys are held for many steps at a time, so runs keep the file small
+    size_t start = 0;
+    while (start < inputs.size())
+    {
+        size_t end = start + 1;
+        while (end < inputs.size() && inputs[end] == inputs[start])
+        {
+            ++end;
+        }
+        out.put(static_cast<char>(inputs[start]));
+        writeVarint(out, end - start);
+        start = end;
+    }
+    return static_cast<bool>(out);
+}
+
+bool ECE_Replay::load(const string& path)
+{
+    seed = 0;
+    inputs.clear();
+
+    ifstream in(path, ios::binary);
+    char magic[sizeof(MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || !equal(magic, magic + sizeof(magic), MAGIC) || in.get() != VERSION)
+    {
+        return false;
+    }
+
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        int byte = in.get();
+        if (byte == EOF)
+        {
+            return false;
+        }
+        value |= static_cast<uint32_t>(byte) << (8 * i);
+    }
+
+    uint64_t steps;
+    if (!readVarint(in, steps) || steps > (1u << 30))
+    {
+        return false;
+    }
+
+    vector<unsigned char> loaded;
+    loaded.reserve(static_cast<size_t>(steps));
+    while (loaded.size() < steps)
+    {
+        int input = in.get();
+        uint64_t length;
+        if (input == EOF || !readVarint(in, length) || length == 0 || length > steps - loaded.size())
+        {
+            return false;
+        }
+        loaded.insert(loaded.end(), static_cast<size_t>(length), static_cast<unsigned char>(input));
+    }
+
+    seed = value;
+    inputs.swap(loaded);
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Keys the game reads on each simulation step, one bit each
+enum ECE_ReplayInput : unsigned char
+{
+    INPUT_LEFT = 1 << 0,
+    INPUT_RIGHT = 1 << 1,
+    INPUT_UP = 1 << 2,
+    INPUT_DOWN = 1 << 3,
+    INPUT_FIRE = 1 << 4
+};
+
+// A recorded session: the random seed the game started from and the keys
+// held on every fixed simulation step. Replaying the same inputs from the
+// same seed reproduces the session exactly, given the same build (standard
+// library random distributions differ between compilers).
+//
+// File layout, integers little-endian:
+//   "ECER", version byte, 32-bit seed, varint step count,
+//   then runs of (input byte, varint run length) covering every step
+class ECE_Replay
+{
+public:
+    void setSeed(std::uint32_t value)
+    {
+        seed = value;
+    }
+
+    std::uint32_t getSeed() const
+    {
+        return seed;
+    }
+
+    // Make room for this many steps, so recording does not allocate mid-game
+    void reserve(int steps)
+    {
+        inputs.reserve(steps);
+    }
+
+    // Append the input for the next step
+    void record(unsigned char input)
+    {
+        inputs.push_back(input);
+    }
+
+    int getStepCount() const
+    {
+        return static_cast<int>(inputs.size());
+    }
+
+    unsigned char getInput(int step) const
+    {
+        return inputs[step];
+    }
+
+    bool save(const std::string& path) const;
+
+    // Returns false, leaving the replay empty, if the file is missing or malformed
+    bool load(const std::string& path);
+
+private:
+    std::uint32_t seed = 0;
+    std::vector<unsigned char> inputs;  // one per step
+};
@@ -0,0 +1,158 @@
+#include "ECE_SpatialHash.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace sf;
+using namespace std;
+
+namespace
+{
+    // Entries a cell holds before its list has to grow; a few more than the
+    // centipede segments or mushrooms that fit in one cell
+    const size_t CELL_CAPACITY = 8;
+}
+
+ECE_SpatialHash::ECE_SpatialHash(float width, float height, float cellSize)
+    : cellSize(cellSize),
+      columns(max(1, static_cast<int>(ceil(width / cellSize)))),
+      rows(max(1, static_cast<int>(ceil(height / cellSize)))),
+      cells(columns * rows)
+{
+    // Entries move into cells they have never been in all game long; with
+    // room set aside up front that never allocates
+    for (auto& cell : cells)
+    {
+        cell.reserve(CELL_CAPACITY);
+    }
+}
+
+void ECE_SpatialHash::cellRange(const FloatRect& bounds, int& left, int& top, int& right, int& bottom) const
+{
+    left = min(max(static_cast<int>(floor(bounds.left / cellSize)), 0), columns - 1);
+    top = min(max(static_cast<int>(floor(bounds.top / cellSize)), 0), rows - 1);
+    right = min(max(static_cast<int>(floor((bounds.left + bounds.width) / cellSize)), 0), columns - 1);
+    bottom = min(max(static_cast<int>(floor((bounds.top + bounds.height) / cellSize)), 0), rows - 1);
+}
+
+void ECE_SpatialHash::link(int id)
+{
+    const Entry& entry = entries[id];
+    for (int y = entry.top; y <= entry.bottom; ++y)
+    {
+        for (int x = entry.left; x <= entry.right; ++x)
+        {
+            cells[y * columns + x].push_back(id);
+        }
+    }
+}
+
+void ECE_SpatialHash::unlink(int id)
+{
+    const Entry& entry = entries[id];
+    for (int y = entry.top; y <= entry.bottom; ++y)
+    {
+        for (int x = entry.left; x <= entry.right; ++x)
+        {
+            vector<int>& cell = cells[y * columns + x];
+            auto found = find(cell.begin(), cell.end(), id);
+            if (found != cell.end())
+            {
+                *found = cell.back();
+                cell.pop_back();
+            }
+        }
+    }
+}
+
+void ECE_SpatialHash::insert(int id, const FloatRect& bounds)
+{
+    if (id >= static_cast<int>(entries.size()))
+    {
+        entries.resize(id + 1);
+        stamps.resize(id + 1, 0);
+    }
+
+    Entry& entry = entries[id];
+    int left, top, right, bottom;
+    cellRange(bounds, left, top, right, bottom);
+    entry.bounds = bounds;
+
+    bool active = entry.activeIndex >= 0;
+    if (active && left == entry.left && top == entry.top && right == entry.right && bottom == entry.bottom)
+    {
+        return;  // Still in the same cells
+    }
+
+    if (active)
+    {
+        unlink(id);
+    }
+    else
+    {
+        entry.activeIndex = static_cast<int>(activeIds.size());
+        activeIds.push_back(id);
+    }
+    entry.left = left;
+    entry.top = top;
+    entry.right = right;
+    entry.bottom = bottom;
+    link(id);
+}
+
+void ECE_SpatialHash::remove(int id)
+{
+    if (id >= static_cast<int>(entries.size()) || entries[id].activeIndex < 0)
+    {
+        return;
+    }
+    unlink(id);
+
+    // Swap the last active id into this one's place
+    int index = entries[id].activeIndex;
+    activeIds[index] = activeIds.back();
+    entries[activeIds[index]].activeIndex = index;
+    activeIds.pop_back();
+    entries[id].activeIndex = -1;
+}
+
+void ECE_SpatialHash::clear()
+{
+    for (int id : activeIds)
+    {
+        unlink(id);
+        entries[id].activeIndex = -1;
+    }
+    activeIds.clear();
+}
+
+void ECE_SpatialHash::query(const FloatRect& area, vector<int>& results) const
+{
+    results.clear();
+    if (++stamp == 0)
+    {
+        // The counter wrapped; old stamps could now collide
+        fill(stamps.begin(), stamps.end(), 0);
+        stamp = 1;
+    }
+
+    int left, top, right, bottom;
+    cellRange(area, left, top, right, bottom);
+    for (int y = top; y <= bottom; ++y)
+    {
+        for (int x = left; x <= right; ++x)
+        {
+            for (int id : cells[y * columns + x])
+            {
+                if (stamps[id] != stamp)
+                {
+                    stamps[id] = stamp;
+                    if (entries[id].bounds.intersects(area))
+                    {
+                        results.push_back(id);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <vector>
+
+// Broad-phase collision grid over the playfield. Each entry is an integer id
+// with a cached bounding box, bucketed into every cell the box overlaps, so a
+// query only looks at entries in the cells around the query box instead of at
+// every entity. Boxes hanging off the playfield are kept in the edge cells.
+class ECE_SpatialHash
+{
+public:
+    ECE_SpatialHash(float width, float height, float cellSize);
+
+    // Add an entry, or move an existing one; the cell lists are only touched
+    // when the box crosses into different cells
+    void insert(int id, const sf::FloatRect& bounds);
+
+    void remove(int id);
+
+    // Remove every entry
+    void clear();
+
+    // Ids of the entries whose boxes intersect area, each listed once
+    void query(const sf::FloatRect& area, std::vector<int>& results) const;
+
+    const sf::FloatRect& getBounds(int id) const
+    {
+        return entries[id].bounds;
+    }
+
+private:
+    struct Entry
+    {
+        sf::FloatRect bounds;
+        int left = 0;
+        int top = 0;
+        int right = -1;
+        int bottom = -1;
+        int activeIndex = -1;  // position in activeIds, -1 when not in the grid
+    };
+
+    // Inclusive range of cells a box overlaps, clamped to the grid
+    void cellRange(const sf::FloatRect& bounds, int& left, int& top, int& right, int& bottom) const;
+    void link(int id);
+    void unlink(int id);
+
+    float cellSize;
+    int columns;
+    int rows;
+    std::vector<std::vector<int>> cells;
+    std::vector<Entry> entries;
+    std::vector<int> activeIds;
+
+    // Query stamps, so an entry spanning several cells is reported once
+    mutable std::vector<unsigned int> stamps;
+    mutable unsigned int stamp = 0;
+};
@@ -1,52 +1,82 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Window.hpp>
+#include <SFML/Audio.hpp>
+#include <cmath>
+#include <memory>
 #include <vector>
-#include <list>
 #include <random>
+#include "TextureAtlas.h"
+#include "ECE_SpatialHash.h"
+#include "ECE_EntityStore.h"
+#include "ECE_AllocationCounter.h"
+#include "ECE_CounterText.h"
+#include "ECE_Replay.h"
+#include "FixedTimestep.h"
+#include "Profiler.h"
+#include "ProfilerOverlay.h"
+#include "SoundBank.h"
+#include "VoicePool.h"
+#include <iostream>
 
 using namespace sf;
 using namespace std;
 
-class ECE_Centipede : public Sprite {
+// Every random decision in the game comes from this one seeded engine, so a
+// replay's seed and inputs reproduce the session
+mt19937 randomEngine;
+
+void seedRandom(uint32_t seed)
+{
+    randomEngine.seed(seed);
+}
+
+int getRandomInt(int min, int max)
+{
+    uniform_int_distribution<> distr(min, max);
+    return distr(randomEngine);
+}
+
+// The centipede's segments live in an entity store; index 0 is the head
+class ECE_Centipede {
 public:
-    ECE_Centipede(Texture& headTexture, Texture& bodyTexture, int segmentsCount = 11)
-        : headTexture(headTexture), bodyTexture(bodyTexture), direction(-1)
+    ECE_Centipede(const TextureAtlas& atlas, SpriteHandle head, SpriteHandle body, int segmentsCount = 11)
+        : segments(atlas), head(head), body(body), direction(-1)
     {
-        setTexture(headTexture);
+        segments.reserve(segmentsCount);
         for (int i = 0; i < segmentsCount; ++i)
         {
-            Texture& texture = (i == 0) ? headTexture : bodyTexture;
-            Sprite segmentSprite(texture);
-
-            const auto& size = segmentSprite.getLocalBounds();
-            segmentSprite.setOrigin(size.width / 2.f, size.height / 2.f);
-
-            segmentSprite.setPosition(800 + i * 20, 50);
-
-            if (i == 0)
-            {
-                segmentSprite.setRotation(180);
-            }
-
-            segments.push_back({segmentSprite, 1});
+            // Segments are laid out by their centres
+            SpriteHandle image = (i == 0) ? head : body;
+            const IntRect& rect = atlas.getRect(image);
+            segments.create(Vector2f(800 + i * 20 - rect.width / 2.f, 50 - rect.height / 2.f), image, 1);
         }
+
+        segments.flipped[0] = 1;  // The head faces the way it moves
     }
 
-    void update()
+    void update(float dt)
     {
+        segments.beginStep();
+
         // Move all segments
-        for (auto& segment : segments)
+        for (auto& position : segments.positions)
+        {
+            position.x += SPEED * direction * dt;
+        }
+
+        if (segments.size() == 0)
         {
-            segment.first.move(2 * direction, 0);
+            return;
         }
 
         // Check if the centipede head reaches the boundary
-        auto& head = segments[0].first;
-        if (direction == 1 && head.getPosition().x + head.getGlobalBounds().width >= 1036)
+        float headWidth = segments.sizes[0].x;
+        float headCentre = segments.positions[0].x + headWidth / 2;
+        if (direction == 1 && headCentre + headWidth >= 1036)
         {
             changeDirectionAndMoveDown();
         }
-        else if (direction == -1 && head.getPosition().x <= 0)
+        else if (direction == -1 && headCentre <= 0)
         {
             changeDirectionAndMoveDown();
         }
@@ -54,104 +84,78 @@ public:
 
     void hit(int index)
     {
-        segments[index].second--;
+        segments.health[index]--;
     }
 
     bool isSegmentDestroyed(int index) const
     {
-        return segments[index].second <= 0;
+        return segments.health[index] <= 0;
     }
 
     void removeDestroyedSegments()
     {
-        segments.erase(
-            remove_if(segments.begin(), segments.end(),
-                           [](const pair<Sprite, int>& segment)
-                           {
-                               return segment.second <= 0;
-                           }),
-            segments.end());
+        segments.removeDead();
     }
 
-    void draw(RenderWindow& window)
+    void draw(RenderWindow& window, float alpha)
     {
-        for (auto& segment : segments)
-        {
-            window.draw(segment.first);
-        }
+        segments.draw(window, alpha);
     }
 
-    const vector<pair<Sprite, int>>& getSegments() const
+    const ECE_EntityStore& getSegments() const
     {
         return segments;
     }
 
 private:
-    vector<pair<Sprite, int>> segments;
+    static constexpr float SPEED = 120;  // Pixels per second
+
+    ECE_EntityStore segments;
+    SpriteHandle head;
+    SpriteHandle body;
     int direction;
-    Texture& headTexture;
-    Texture& bodyTexture;
 
     void changeDirectionAndMoveDown()
     {
         direction *= -1;
 
-        if (direction == 1)
-        {
-            swap(segments.front(), segments.back());
-            segments[0].first.setRotation(0);
-        }
-        else
-        {
-            swap(segments.back(), segments.front());
-            segments[0].first.setRotation(180);
-        }
+        // The tail leads the way back
+        segments.swapEntries(0, segments.size() - 1);
+        segments.flipped[0] = (direction == -1);
 
         // Move all segments down
-        for (auto& segment : segments)
+        for (auto& position : segments.positions)
         {
-            segment.first.move(0, 20);
+            position.y += 20;
         }
 
         // Update head texture
-        segments[0].first.setTexture(headTexture);
+        segments.setSprite(0, head);
         for (int i = 1; i < segments.size(); ++i)
         {
-            segments[i].first.setTexture(bodyTexture);
+            segments.setSprite(i, body);
         }
     }
 };
 
-class ECE_LaserBlast : public Sprite {
-public:
-    ECE_LaserBlast(Texture& texture)
-    {
-        setTexture(texture);
-    }
-
-    void update()
-    {
-        move(0, -5);  // Move upwards
-    }
-};
-
-class Mushroom {
+class Spider : public Sprite {
 public:
-    Mushroom(const vector<Texture>& textures, float x, float y)
-        : textures(textures), health(2)
+    Spider(const TextureAtlas& atlas, SpriteHandle handle) : health(1)
     {
-        sprite.setTexture(textures[0]);  // Start with the first texture
-        sprite.setPosition(x, y);
+        atlas.apply(*this, handle);
+        setPosition(300, 300);
     }
 
-    Sprite& getSprite()
+    // Random jitter, scaled to the step length so it shakes as fast as the
+    // original +-20 by +-10 pixels per frame did at 60 fps
+    void update(float dt)
     {
-        return sprite;
+        move(getRandomInt(-20, 20) * dt * 60, getRandomInt(-10, 10) * dt * 60);
     }
 
-    const Sprite& getSprite() const
+    void hit()
     {
-        return sprite;
+        health--;
     }
 
     bool isDestroyed() const
@@ -159,371 +163,597 @@ public:
         return health <= 0;
     }
 
-    void hit()
+    void setRandomPosition()
     {
-        health--;
-        if (health == 1)
-        {
-            sprite.setTexture(textures[1]);  // Change to second texture on first hit
-        }
-        else if (health <= 0)
-        {
-            sprite.setColor(Color::Transparent);  // Make the mushroom invisible when destroyed
-        }
+        float x = getRandomInt(0, 1000 - getGlobalBounds().width);
+        float y = getRandomInt(0, 500 - getGlobalBounds().height);
+        setPosition(x, y);
     }
 
 private:
-    Sprite sprite;
-    vector<Texture> textures;
     int health;
 };
 
-class Spider : public Sprite {
-public:
-    Spider(Texture& texture) : health(1)
+// The game ships no sound files, so its effects are made at startup: a
+// square wave sweeping from startHz to endHz, mixed with noise, fading out
+SoundBuffer makeEffect(float startHz, float endHz, float seconds, float noise)
+{
+    const unsigned int SAMPLE_RATE = 44100;
+    vector<Int16> samples(static_cast<size_t>(seconds * SAMPLE_RATE));
+    minstd_rand noiseSource(1);  // Its own engine, so replays are unaffected
+    uniform_real_distribution<float> noiseSample(-1.f, 1.f);
+    float phase = 0;
+    for (size_t i = 0; i < samples.size(); ++i)
     {
-        setTexture(texture);
-        setPosition(300, 300);
+        float t = static_cast<float>(i) / samples.size();
+        phase += (startHz + (endHz - startHz) * t) / SAMPLE_RATE;
+        float square = (phase - floor(phase)) < 0.5f ? 1.f : -1.f;
+        float value = square * (1 - noise) + noiseSample(noiseSource) * noise;
+        samples[i] = static_cast<Int16>(value * (1 - t) * 8000);
     }
 
-    void update()
+    SoundBuffer buffer;
+    buffer.loadFromSamples(samples.data(), samples.size(), 1, SAMPLE_RATE);
+    return buffer;
+}
+
+int main(int argc, char* argv[])
+{
+    // -record <file> saves the session as a replay when the game closes;
+    // -replay <file> plays one back without a window, as fast as it will go;
+    // -trace <file> saves the last frames' profile as a Chrome trace on exit
+    string recordPath;
+    string replayPath;
+    string tracePath;
+    for (int i = 1; i + 1 < argc; i += 2)
     {
-        move(getRandomInt(-20, 20), getRandomInt(-10, 10));
+        string flag = argv[i];
+        if (flag == "-record")
+        {
+            recordPath = argv[i + 1];
+        }
+        else if (flag == "-replay")
+        {
+            replayPath = argv[i + 1];
+        }
+        else if (flag == "-trace")
+        {
+            tracePath = argv[i + 1];
+        }
+        else
+        {
+            cerr << "Unknown option " << flag << endl;
+            return 1;
+        }
     }
 
-    void hit()
+    ECE_Replay replay;
+    bool headless = !replayPath.empty();
+    if (headless)
     {
-        health--;
+        if (!replay.load(replayPath))
+        {
+            cerr << "Could not read replay " << replayPath << endl;
+            return 1;
+        }
     }
-
-    bool isDestroyed() const
+    else
     {
-        return health <= 0;
+        replay.setSeed(random_device{}());
+        if (!recordPath.empty())
+        {
+            replay.reserve(120 * 60 * 60);  // An hour of steps
+        }
     }
+    seedRandom(replay.getSeed());
 
-    void setRandomPosition()
+    const int SCREEN_WIDTH = 1036;
+    const int SCREEN_HEIGHT = 569;
+    // Playback has no window, nor any texture: each of those needs a GL
+    // context, and creating one aborts on a machine without a display
+    unique_ptr<RenderWindow> window;
+    if (!headless)
     {
-        float x = getRandomInt(0, 1000 - getGlobalBounds().width);
-        float y = getRandomInt(0, 500 - getGlobalBounds().height);
-        setPosition(x, y);
+        window = make_unique<RenderWindow>(VideoMode(SCREEN_WIDTH, SCREEN_HEIGHT), "Centipede Game");
+        window->setVerticalSyncEnabled(true);
     }
 
-private:
-    int getRandomInt(int min, int max)
+    // The game advances in fixed 1/120 s steps however fast frames are drawn
+    const Time TIME_STEP = seconds(1.f / 120);
+    const int MAX_STEPS_PER_FRAME = 8;
+    const float SHIP_SPEED = 300;  // Pixels per second
+    FixedTimestep timestep(TIME_STEP, MAX_STEPS_PER_FRAME);
+    const float dt = timestep.getStepSeconds();
+
+    // Load every sprite image once into a shared atlas
+    TextureAtlas atlas;
+    SpriteHandle centipedeHead = atlas.add("graphics/CentipedeHead.png");
+    SpriteHandle centipedeBody = atlas.add("graphics/CentipedeBody.png");
+    SpriteHandle mushroomHealthy = atlas.add("graphics/Mushroom0.png");
+    SpriteHandle mushroomDamaged = atlas.add("graphics/Mushroom1.png");
+    SpriteHandle spaceshipImage = atlas.add("graphics/StarShip.png");
+    SpriteHandle laserBlastImage = atlas.add("graphics/Laser.png");
+    SpriteHandle spiderImage = atlas.add("graphics/spider.png");
+    atlas.build(!headless);
+
+    // The title screen is only shown on its own, so it keeps a texture of its own
+    unique_ptr<Texture> startupTexture;
+    if (!headless)
     {
-        static random_device rd;
-        static mt19937 gen(rd());
-        uniform_int_distribution<> distr(min, max);
-        return distr(gen);
+        startupTexture = make_unique<Texture>();
+        startupTexture->loadFromFile("graphics/Startup Screen BackGround.png");
     }
 
-    int health;
-};
+    // Create centipede with head and body images
+    ECE_Centipede centipede(atlas, centipedeHead, centipedeBody);
 
-int getRandomInt(int min, int max)
-{
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> distr(min, max);
-    return distr(gen);
-}
+    // Collision grids: mushrooms never move, so their boxes are cached once;
+    // the centipede moves every frame and is re-bucketed after each move
+    const float COLLISION_CELL_SIZE = 32;
+    ECE_SpatialHash mushroomGrid(SCREEN_WIDTH, SCREEN_HEIGHT, COLLISION_CELL_SIZE);
+    ECE_SpatialHash segmentGrid(SCREEN_WIDTH, SCREEN_HEIGHT, COLLISION_CELL_SIZE);
+    vector<int> nearby;
 
-int main()
-{
-    const int SCREEN_WIDTH = 1036;
-    const int SCREEN_HEIGHT = 569;
-    RenderWindow window(VideoMode(SCREEN_WIDTH, SCREEN_HEIGHT), "Centipede Game");
-    window.setFramerateLimit(60);
-
-    // Load textures
-    Texture centipedeHeadTexture;
-    Texture centipedeBodyTexture;
-    Texture mushroomTextures[2];
-    Texture spaceshipTexture;
-    Texture laserBlastTexture;
-    Texture spiderTexture;
-    Texture startupTexture;
-
-    centipedeHeadTexture.loadFromFile("graphics/CentipedeHead.png");
-    centipedeBodyTexture.loadFromFile("graphics/CentipedeBody.png");
-    mushroomTextures[0].loadFromFile("graphics/Mushroom0.png");
-    mushroomTextures[1].loadFromFile("graphics/Mushroom1.png");
-    spaceshipTexture.loadFromFile("graphics/StarShip.png");
-    laserBlastTexture.loadFromFile("graphics/Laser.png");
-    spiderTexture.loadFromFile("graphics/Spider.png");
-    startupTexture.loadFromFile("graphics/Startup Screen BackGround.png");
-
-    // Create a vector of textures for the mushrooms
-    vector<Texture> mushroomTextureVector(mushroomTextures, mushroomTextures + 2);
-
-    // Create centipede with head and body textures
-    ECE_Centipede centipede(centipedeHeadTexture, centipedeBodyTexture);
-
-    // Create mushrooms
-    list<Mushroom> mushrooms;
+    // Create mushrooms; their collision grid ids index mushroomHandles
+    ECE_EntityStore mushrooms(atlas);
+    vector<ECE_EntityHandle> mushroomHandles;
+    mushrooms.reserve(30);
     for (int i = 0; i < 30; ++i)
     {
         float x = getRandomInt(0, SCREEN_WIDTH - 40);
         float y = getRandomInt(0, SCREEN_HEIGHT - 100);
-        mushrooms.emplace_back(mushroomTextureVector, x, y);
+        mushroomHandles.push_back(mushrooms.create(Vector2f(x, y), mushroomHealthy, 2));
+        mushroomGrid.insert(i, mushrooms.getBounds(i));
     }
 
+    // Room for every entry of either grid, so queries never grow the results
+    nearby.reserve(max(mushrooms.size(), centipede.getSegments().size()));
+
+    // Damage a mushroom by grid id: the first hit shows the damaged image, the
+    // second takes it out of the grid at once and out of the store at the end of the step
+    auto hitMushroom = [&](int id)
+    {
+        int i = mushrooms.indexOf(mushroomHandles[id]);
+        mushrooms.health[i]--;
+        if (mushrooms.health[i] == 1)
+        {
+            mushrooms.setSprite(i, mushroomDamaged);
+        }
+        else if (mushrooms.health[i] <= 0)
+        {
+            mushroomGrid.remove(id);
+        }
+    };
+
+    // Grid ids are segment indices, so they stay in place and only the ids
+    // left past the end by removed segments are dropped
+    int segmentGridSize = 0;
+    auto updateSegmentGrid = [&]()
+    {
+        const ECE_EntityStore& centipedeSegments = centipede.getSegments();
+        for (int i = 0; i < centipedeSegments.size(); ++i)
+        {
+            segmentGrid.insert(i, centipedeSegments.getBounds(i));
+        }
+        for (int i = centipedeSegments.size(); i < segmentGridSize; ++i)
+        {
+            segmentGrid.remove(i);
+        }
+        segmentGridSize = centipedeSegments.size();
+    };
+    updateSegmentGrid();
+
     // Create spaceship
-    Sprite spaceship(spaceshipTexture);
+    Sprite spaceship;
+    atlas.apply(spaceship, spaceshipImage);
     spaceship.setPosition(SCREEN_WIDTH / 2 - spaceship.getGlobalBounds().width / 2, SCREEN_HEIGHT - spaceship.getGlobalBounds().height);
 
     // Laser blasts
-    list<ECE_LaserBlast> laserBlasts;
+    const float LASER_SPEED = 300;  // Pixels per second
+    // A fixed-size pool: with the fire cooldown only a handful are ever on
+    // screen, and a full pool just holds fire instead of growing
+    const int MAX_LASER_BLASTS = 32;
+    ECE_EntityStore laserBlasts(atlas);
+    laserBlasts.reserve(MAX_LASER_BLASTS);
 
     // Create spider
-    Spider spider(spiderTexture);
+    Spider spider(atlas, spiderImage);
 
     // Score and lives
     int score = 0;
     int lives = 3;
     Font font;
     font.loadFromFile("fonts/KOMIKAP_.ttf");
-    Text scoreText("Score: 0", font, 20);
-    Text livesText("Lives: 3", font, 20);
-    scoreText.setPosition(10, 10);
-    livesText.setPosition(SCREEN_WIDTH - livesText.getGlobalBounds().width - 10, 10);
+    ECE_CounterText scoreText("Score: ", font, 20, score);
+    ECE_CounterText livesText("Lives: ", font, 20, lives);
 
-    bool gameStarted = false;
+    // The title and game over screens are built once, not every frame
+    Sprite startupScreen;
+    if (startupTexture)
+    {
+        startupScreen.setTexture(*startupTexture, true);
+    }
+    Text gameOverText("Game Over", font, 40);
+
+    // Measuring text renders its glyphs, which needs a window
+    if (!headless)
+    {
+        scoreText.warmUp();
+        livesText.warmUp();
+        scoreText.getText().setPosition(10, 10);
+        livesText.getText().setPosition(SCREEN_WIDTH - livesText.getText().getGlobalBounds().width - 10, 10);
+        gameOverText.setPosition(SCREEN_WIDTH / 2 - gameOverText.getGlobalBounds().width / 2, SCREEN_HEIGHT / 2);
+    }
+
+    // Sound effects, loaded once and played through a fixed pool of voices;
+    // when all are busy the least important sound is cut off. Playback
+    // without a window stays silent and never opens the audio device.
+    SoundBank soundBank;
+    int laserSound = -1;
+    int hitSound = -1;
+    int explosionSound = -1;
+    int shipHitSound = -1;
+    if (!headless)
+    {
+        laserSound = soundBank.add(makeEffect(1400, 300, 0.15f, 0.f), 0);
+        hitSound = soundBank.add(makeEffect(300, 150, 0.08f, 0.6f), 1);
+        explosionSound = soundBank.add(makeEffect(200, 40, 0.5f, 0.8f), 2);
+        shipHitSound = soundBank.add(makeEffect(600, 60, 0.8f, 0.3f), 3);
+    }
+    VoicePool sounds(soundBank, headless ? 0 : 16);
+
+    // Where each frame's time goes; F3 shows the overlay, F4 saves a trace
+    Profiler profiler;
+    ProfilerOverlay profilerOverlay(profiler, font);
+    profilerOverlay.setPosition(SCREEN_WIDTH - 370, 40);
+    bool showProfiler = false;
+
+    // Debug builds report every frame that allocates
+    ECE_AllocationCounter frameAllocations;
+    long frameNumber = 0;
+
+    bool gameStarted = headless;  // Playback skips the title screen
+    int replayStep = 0;
 
     // Fire cooldown variables
     float fireCooldown = 0.3f;
     float lastFireTime = 0.0f;
 
-    Clock clock;
+    // Time as the simulation sees it, and where things were one step ago
+    Clock frameClock;
+    float simulationTime = 0.0f;
+    Vector2f spaceshipPrevious = spaceship.getPosition();
+    Vector2f spiderPrevious = spider.getPosition();
     bool gameOver = false;
 
-    while (window.isOpen())
+    Clock playbackClock;
+    while (headless ? (replayStep < replay.getStepCount() && !gameOver) : window->isOpen())
     {
+        // Report the frame just finished, then start counting this one
+        size_t allocations = frameAllocations.getFrameCount();
+        if (ECE_AllocationCounter::isEnabled() && frameNumber > 0 && allocations > 0)
+        {
+            cerr << "Frame " << frameNumber << ": " << allocations << " heap allocations" << endl;
+        }
+        frameAllocations.beginFrame();
+        ++frameNumber;
+
+        // Likewise close the previous frame's profile and start this one
+        profiler.endFrame();
+        if (showProfiler)
+        {
+            profilerOverlay.update();
+        }
+        profiler.beginFrame();
+
+        // Restart every frame so time spent on the title screen is not simulated
+        Time frameTime = frameClock.restart();
+
+        profiler.beginZone("input");
         Event event;
-        while (window.pollEvent(event))
+        while (window && window->pollEvent(event))
         {
             if (event.type == Event::Closed)
             {
-                window.close();
+                window->close();
             }
 
             if (event.type == Event::KeyPressed && event.key.code == Keyboard::Enter)
             {
                 gameStarted = true;
             }
+
+            if (event.type == Event::KeyPressed && event.key.code == Keyboard::F3)
+            {
+                showProfiler = !showProfiler;
+            }
+
+            if (event.type == Event::KeyPressed && event.key.code == Keyboard::F4)
+            {
+                profiler.writeChromeTrace("profile.json");
+            }
         }
+        profiler.endZone();
 
         // If the game is over, display the "Game Over" screen
         if (gameOver)
         {
-            window.clear();
-            Text gameOverText("Game Over", font, 40);
-            gameOverText.setPosition(SCREEN_WIDTH / 2 - gameOverText.getGlobalBounds().width / 2, SCREEN_HEIGHT / 2);
-            window.draw(gameOverText);
-            window.display();
+            window->clear();
+            window->draw(gameOverText);
+            window->display();
             continue;  // Skip the rest of the game logic
         }
 
         // Normal game logic continues here
         if (!gameStarted)
         {
-            window.clear();
-            Sprite startupScreen(startupTexture);
-            window.draw(startupScreen);
-            window.display();
+            window->clear();
+            window->draw(startupScreen);
+            window->display();
             continue;
         }
 
-        float currentTime = clock.getElapsedTime().asSeconds();
-
-        // Move spaceship
-        if (Keyboard::isKeyPressed(Keyboard::Left))
+        // Run the simulation for every whole step of time that has passed;
+        // playback runs one step per pass, as fast as it can
+        int steps = headless ? 1 : timestep.advance(frameTime);
+        profiler.beginZone("update");
+        for (int step = 0; step < steps && !gameOver; ++step)
         {
-            spaceship.move(-5, 0);
-        }
+            simulationTime += dt;
+            float currentTime = simulationTime;
+            spaceshipPrevious = spaceship.getPosition();
+            spiderPrevious = spider.getPosition();
+            laserBlasts.beginStep();
 
-        if (Keyboard::isKeyPressed(Keyboard::Right))
-        {
-            spaceship.move(5, 0);
-        }
+            // Keys held this step, from the replay when playing one back
+            unsigned char input;
+            if (headless)
+            {
+                input = replay.getInput(replayStep++);
+            }
+            else
+            {
+                input = (Keyboard::isKeyPressed(Keyboard::Left) ? INPUT_LEFT : 0) |
+                        (Keyboard::isKeyPressed(Keyboard::Right) ? INPUT_RIGHT : 0) |
+                        (Keyboard::isKeyPressed(Keyboard::Up) ? INPUT_UP : 0) |
+                        (Keyboard::isKeyPressed(Keyboard::Down) ? INPUT_DOWN : 0) |
+                        (Keyboard::isKeyPressed(Keyboard::Space) ? INPUT_FIRE : 0);
+                if (!recordPath.empty())
+                {
+                    replay.record(input);
+                }
+            }
 
-        if (Keyboard::isKeyPressed(Keyboard::Up))
-        {
-            spaceship.move(0, -5);
-        }
+            // Move spaceship
+            if (input & INPUT_LEFT)
+            {
+                spaceship.move(-SHIP_SPEED * dt, 0);
+            }
 
-        if (Keyboard::isKeyPressed(Keyboard::Down))
-        {
-            spaceship.move(0, 5);
-        }
+            if (input & INPUT_RIGHT)
+            {
+                spaceship.move(SHIP_SPEED * dt, 0);
+            }
 
-        // Keep spaceship within the screen
-        if (spaceship.getPosition().x < 0)
-        {
-            spaceship.setPosition(0, spaceship.getPosition().y);
-        }
+            if (input & INPUT_UP)
+            {
+                spaceship.move(0, -SHIP_SPEED * dt);
+            }
 
-        if (spaceship.getPosition().x + spaceship.getGlobalBounds().width > SCREEN_WIDTH)
-        {
-            spaceship.setPosition(SCREEN_WIDTH - spaceship.getGlobalBounds().width, spaceship.getPosition().y);
-        }
+            if (input & INPUT_DOWN)
+            {
+                spaceship.move(0, SHIP_SPEED * dt);
+            }
 
-        if (spaceship.getPosition().y < 0)
-        {
-            spaceship.setPosition(spaceship.getPosition().x, 0);
-        }
+            // Keep spaceship within the screen
+            if (spaceship.getPosition().x < 0)
+            {
+                spaceship.setPosition(0, spaceship.getPosition().y);
+            }
 
-        if (spaceship.getPosition().y + spaceship.getGlobalBounds().height > SCREEN_HEIGHT)
-        {
-            spaceship.setPosition(spaceship.getPosition().x, SCREEN_HEIGHT - spaceship.getGlobalBounds().height);
-        }
+            if (spaceship.getPosition().x + spaceship.getGlobalBounds().width > SCREEN_WIDTH)
+            {
+                spaceship.setPosition(SCREEN_WIDTH - spaceship.getGlobalBounds().width, spaceship.getPosition().y);
+            }
 
-        // Keep spider within the screen
-        if (spider.getPosition().x < 0)
-        {
-            spider.setPosition(0, spider.getPosition().y);
-        }
+            if (spaceship.getPosition().y < 0)
+            {
+                spaceship.setPosition(spaceship.getPosition().x, 0);
+            }
 
-        if (spider.getPosition().x + spider.getGlobalBounds().width > SCREEN_WIDTH)
-        {
-            spider.setPosition(SCREEN_WIDTH - spider.getGlobalBounds().width, spider.getPosition().y);
-        }
+            if (spaceship.getPosition().y + spaceship.getGlobalBounds().height > SCREEN_HEIGHT)
+            {
+                spaceship.setPosition(spaceship.getPosition().x, SCREEN_HEIGHT - spaceship.getGlobalBounds().height);
+            }
 
-        if (spider.getPosition().y < 0)
-        {
-            spider.setPosition(spider.getPosition().x, 0);
-        }
+            // Keep spider within the screen
+            if (spider.getPosition().x < 0)
+            {
+                spider.setPosition(0, spider.getPosition().y);
+            }
 
-        if (spider.getPosition().y + spider.getGlobalBounds().height > SCREEN_HEIGHT)
-        {
-            spider.setPosition(spider.getPosition().x, SCREEN_HEIGHT - spider.getGlobalBounds().height);
-        }
+            if (spider.getPosition().x + spider.getGlobalBounds().width > SCREEN_WIDTH)
+            {
+                spider.setPosition(SCREEN_WIDTH - spider.getGlobalBounds().width, spider.getPosition().y);
+            }
 
-        // Laser firing logic with cooldown
-        if (Keyboard::isKeyPressed(Keyboard::Space) && (currentTime - lastFireTime > fireCooldown))
-        {
-            laserBlasts.push_back(ECE_LaserBlast(laserBlastTexture));
-            laserBlasts.back().setPosition(spaceship.getPosition().x - 20, spaceship.getPosition().y);
-            lastFireTime = currentTime;
-        }
+            if (spider.getPosition().y < 0)
+            {
+                spider.setPosition(spider.getPosition().x, 0);
+            }
 
-        // Update laser blasts
-        for (auto it = laserBlasts.begin(); it != laserBlasts.end(); )
-        {
-            it->update();
-            bool hitSomething = false;
+            if (spider.getPosition().y + spider.getGlobalBounds().height > SCREEN_HEIGHT)
+            {
+                spider.setPosition(spider.getPosition().x, SCREEN_HEIGHT - spider.getGlobalBounds().height);
+            }
+
+            // Laser firing logic with cooldown
+            if ((input & INPUT_FIRE) && (currentTime - lastFireTime > fireCooldown) &&
+                laserBlasts.size() < MAX_LASER_BLASTS)
+            {
+                laserBlasts.create(Vector2f(spaceship.getPosition().x - 20, spaceship.getPosition().y), laserBlastImage, 1);
+                sounds.play(laserSound);
+                lastFireTime = currentTime;
+            }
+
+            // Update laser blasts
+            for (auto& position : laserBlasts.positions)
+            {
+                position.y -= LASER_SPEED * dt;  // Move upwards
+            }
 
-            // Check for collisions with mushrooms
-            for (auto& mushroom : mushrooms)
+            profiler.beginZone("collision");
+            FloatRect spiderBounds = spider.getGlobalBounds();
+            for (int blast = 0; blast < laserBlasts.size(); ++blast)
             {
-                if (it->getGlobalBounds().intersects(mushroom.getSprite().getGlobalBounds()))
+                bool hitSomething = false;
+                FloatRect blastBounds = laserBlasts.getBounds(blast);
+
+                // Check for collisions with mushrooms in the cells around the blast
+                mushroomGrid.query(blastBounds, nearby);
+                for (int id : nearby)
                 {
-                    mushroom.hit();
+                    hitMushroom(id);
                     hitSomething = true;
                     score += 10;
+                    sounds.play(hitSound);
                 }
-            }
 
-            // Check for collisions with spider
-            if (it->getGlobalBounds().intersects(spider.getGlobalBounds()))
-            {
-                spider.hit();
-                if (spider.isDestroyed())
+                // Check for collisions with spider
+                if (blastBounds.intersects(spiderBounds))
                 {
-                    score += 100;
-                    spider.setRandomPosition();
-                }
+                    spider.hit();
+                    sounds.play(hitSound);
+                    if (spider.isDestroyed())
+                    {
+                        score += 100;
+                        sounds.play(explosionSound);
+                        spider.setRandomPosition();
+                        spiderBounds = spider.getGlobalBounds();
+                    }
 
-                hitSomething = true;
-            }
+                    hitSomething = true;
+                }
 
-            // Check for collisions with centipede segments
-            const auto& centipedeSegments = centipede.getSegments();
-            for (int i = 0; i < centipedeSegments.size(); ++i)
-            {
-                if (it->getGlobalBounds().intersects(centipedeSegments[i].first.getGlobalBounds()))
+                // Check for collisions with centipede segments
+                segmentGrid.query(blastBounds, nearby);
+                for (int i : nearby)
                 {
                     centipede.hit(i);
+                    sounds.play(hitSound);
                     if (centipede.isSegmentDestroyed(i))
                     {
                         score += 50;
+                        sounds.play(explosionSound, 60.f, 1.5f);
                     }
 
                     hitSomething = true;
                 }
-            }
 
-            // Remove the laser blast if it hit something or went off the screen
-            if (hitSomething || it->getPosition().y < 0)
-            {
-                it = laserBlasts.erase(it);
+                // Remove the laser blast if it hit something or went off the screen
+                if (hitSomething || laserBlasts.positions[blast].y < 0)
+                {
+                    laserBlasts.health[blast] = 0;
+                }
             }
-            else
+
+            profiler.endZone();
+
+            laserBlasts.removeDead();
+
+            centipede.removeDestroyedSegments();
+
+            // Remove the spider if destroyed
+            if (spider.isDestroyed())
             {
-                ++it;
+                // Optionally respawn the spider after some time
             }
-        }
-
-        centipede.removeDestroyedSegments();
 
-        // Remove the spider if destroyed
-        if (spider.isDestroyed())
-        {
-            // Optionally respawn the spider after some time
-        }
+            // Remove destroyed mushrooms
+            mushrooms.removeDead();
 
-        // Remove destroyed mushrooms
-        mushrooms.remove_if([](const Mushroom& mushroom) { return mushroom.isDestroyed(); });
+            centipede.update(dt);
+            updateSegmentGrid();
+            spider.update(dt);
 
-        centipede.update();
-        spider.update();
+            // Check for collisions with the spaceship
+            profiler.beginZone("collision");
+            if (spider.getGlobalBounds().intersects(spaceship.getGlobalBounds()))
+            {
+                spaceship.setPosition(SCREEN_WIDTH / 2 - spaceship.getGlobalBounds().width / 2, SCREEN_HEIGHT - spaceship.getGlobalBounds().height);  // Reset spaceship position
+                lives--;
+                sounds.play(shipHitSound);
+            }
 
-        // Check for collisions with the spaceship
-        if (spider.getGlobalBounds().intersects(spaceship.getGlobalBounds()))
-        {
-            spaceship.setPosition(SCREEN_WIDTH / 2 - spaceship.getGlobalBounds().width / 2, SCREEN_HEIGHT - spaceship.getGlobalBounds().height);  // Reset spaceship position
-            lives--;
-        }
+            mushroomGrid.query(spider.getGlobalBounds(), nearby);
+            for (int id : nearby)
+            {
+                hitMushroom(id);
+            }
+            profiler.endZone();
 
-        for (auto& mushroom : mushrooms)
-        {
-            if (spider.getGlobalBounds().intersects(mushroom.getSprite().getGlobalBounds()))
+            // Game over condition
+            if (lives <= 0)
             {
-                mushroom.hit();
+                gameOver = true;
             }
+
+            // Update score and lives text
+            scoreText.setValue(score);
+            livesText.setValue(lives);
         }
 
-        // Game over condition
-        if (lives <= 0)
+        profiler.endZone();
+
+        if (headless)
         {
-            gameOver = true;
+            continue;
         }
 
-        // Update score and lives text
-        scoreText.setString("Score: " + to_string(score));
-        livesText.setString("Lives: " + to_string(lives));
+        // Draw moving things part of the way into the next step
+        profiler.beginZone("draw");
+        float alpha = timestep.getAlpha();
+        window->clear();
+        window->draw(spaceship, interpolate(spaceshipPrevious, spaceship.getPosition(), alpha));
+        window->draw(spider, interpolate(spiderPrevious, spider.getPosition(), alpha));
 
-        window.clear();
-        window.draw(spaceship);
-        window.draw(spider);
+        mushrooms.draw(*window, alpha);
+        laserBlasts.draw(*window, alpha);
 
-        for (const auto& mushroom : mushrooms)
-        {
-            window.draw(mushroom.getSprite());
-        }
+        centipede.draw(*window, alpha);
+
+        // Draw score and lives
+        window->draw(scoreText.getText());
+        window->draw(livesText.getText());
 
-        for (const auto& blast : laserBlasts)
+        if (showProfiler)
         {
-            window.draw(blast);
+            window->draw(profilerOverlay);
         }
+        profiler.endZone();
 
-        centipede.draw(window);
+        profiler.beginZone("display");
+        window->display();
+        profiler.endZone();
+    }
+    profiler.endFrame();
 
-        // Draw score and lives
-        window.draw(scoreText);
-        window.draw(livesText);
+    if (!tracePath.empty() && !profiler.writeChromeTrace(tracePath))
+    {
+        cerr << "Could not write trace " << tracePath << endl;
+    }
 
-        window.display();
+    if (headless)
+    {
+        float seconds = playbackClock.getElapsedTime().asSeconds();
+        cout << "Replayed " << replayStep << " steps in " << seconds << " s (" << replayStep / max(seconds, 1e-6f)
+             << " steps/s)" << endl;
+        cout << "Score " << score << ", lives " << lives << (gameOver ? ", game over" : "") << endl;
+    }
+    else if (!recordPath.empty() && !replay.save(recordPath))
+    {
+        cerr << "Could not write replay " << recordPath << endl;
+        return 1;
     }
 
     return 0;
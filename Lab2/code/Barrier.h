@@ -0,0 +1,31 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+
+// Reusable barrier for a fixed number of threads (std::barrier needs C++20).
+// The generation counter lets the same barrier be waited on every frame
+// without a fast thread slipping through the next phase early.
+class Barrier {
+public:
+    explicit Barrier(int count) : m_count(count), m_waiting(0), m_generation(0) {}
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        unsigned long generation = m_generation;
+        if (++m_waiting == m_count) {
+            m_waiting = 0;
+            ++m_generation;
+            m_condition.notify_all();
+        } else {
+            m_condition.wait(lock, [&] { return generation != m_generation; });
+        }
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    int m_count;
+    int m_waiting;
+    unsigned long m_generation;
+};
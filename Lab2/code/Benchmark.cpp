@@ -0,0 +1,125 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+namespace {
+
+// Nearest-rank percentile of an already sorted sample set
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    if (rank == 0) rank = 1;
+    return sorted[std::min(rank, sorted.size()) - 1];
+}
+
+// Join per-thread values with ';' so they stay in one CSV column
+template <typename T>
+std::string joinValues(const std::vector<T>& values, const char* separator) {
+    std::stringstream stream;
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) stream << separator;
+        stream << values[i];
+    }
+    return stream.str();
+}
+
+// Larger than Life rulestrings contain commas and have to be quoted
+std::string csvField(const std::string& text) {
+    return text.find(',') == std::string::npos ? text : '"' + text + '"';
+}
+
+} // namespace
+
+double loadImbalance(const BenchmarkResult& result) {
+    if (result.threadBusyMicros.empty()) return 1.0;
+    double total = std::accumulate(result.threadBusyMicros.begin(), result.threadBusyMicros.end(), 0.0);
+    double slowest = *std::max_element(result.threadBusyMicros.begin(), result.threadBusyMicros.end());
+    double mean = total / result.threadBusyMicros.size();
+    return mean > 0 ? slowest / mean : 1.0;
+}
+
+void summarizeGenerations(BenchmarkResult& result, std::vector<double> generationMicros) {
+    std::sort(generationMicros.begin(), generationMicros.end());
+    result.generations = static_cast<int>(generationMicros.size());
+    result.totalMicros = std::accumulate(generationMicros.begin(), generationMicros.end(), 0.0);
+    if (generationMicros.empty()) return;
+
+    result.meanMicros = result.totalMicros / generationMicros.size();
+    result.minMicros = generationMicros.front();
+    result.p50Micros = percentile(generationMicros, 50);
+    result.p90Micros = percentile(generationMicros, 90);
+    result.p99Micros = percentile(generationMicros, 99);
+    result.maxMicros = generationMicros.back();
+    if (result.totalMicros > 0) {
+        double cells = static_cast<double>(result.width) * result.height * result.generations * result.generationsPerStep;
+        result.cellsPerSecond = cells / (result.totalMicros / 1e6);
+    }
+}
+
+void writeBenchmarkCsv(std::ostream& out, const std::vector<BenchmarkResult>& results) {
+    out << "engine,rule,width,height,threads,schedule,tile,generations,generations_per_step,seed,total_us,mean_us,min_us,p50_us,p90_us,p99_us,max_us,cells_per_sec,population,imbalance,steals,thread_busy_us,thread_tiles\n";
+    for (const auto& r : results) {
+        out << r.engine << ',' << csvField(r.rule) << ',' << r.width << ',' << r.height << ',' << r.threads << ','
+            << r.schedule << ',' << r.tileWidth << 'x' << r.tileHeight << ','
+            << r.generations << ',' << r.generationsPerStep << ',' << r.seed << ',' << r.totalMicros << ',' << r.meanMicros << ','
+            << r.minMicros << ',' << r.p50Micros << ',' << r.p90Micros << ',' << r.p99Micros << ','
+            << r.maxMicros << ',' << r.cellsPerSecond << ',' << r.finalPopulation << ','
+            << loadImbalance(r) << ',' << r.steals << ',' << joinValues(r.threadBusyMicros, ";") << ','
+            << joinValues(r.threadTiles, ";") << '\n';
+    }
+}
+
+void writeBenchmarkJson(std::ostream& out, const std::vector<BenchmarkResult>& results) {
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "  {\"engine\": \"" << r.engine << "\", \"rule\": \"" << r.rule << "\", \"width\": " << r.width
+            << ", \"height\": " << r.height << ", \"threads\": " << r.threads
+            << ", \"schedule\": \"" << r.schedule << "\", \"tile_width\": " << r.tileWidth
+            << ", \"tile_height\": " << r.tileHeight
+            << ", \"generations\": " << r.generations << ", \"generations_per_step\": " << r.generationsPerStep
+            << ", \"seed\": " << r.seed
+            << ", \"total_us\": " << r.totalMicros << ", \"mean_us\": " << r.meanMicros
+            << ", \"min_us\": " << r.minMicros << ", \"p50_us\": " << r.p50Micros
+            << ", \"p90_us\": " << r.p90Micros << ", \"p99_us\": " << r.p99Micros
+            << ", \"max_us\": " << r.maxMicros << ", \"cells_per_sec\": " << r.cellsPerSecond
+            << ", \"population\": " << r.finalPopulation << ", \"imbalance\": " << loadImbalance(r)
+            << ", \"steals\": " << r.steals
+            << ", \"thread_busy_us\": [" << joinValues(r.threadBusyMicros, ", ") << "]"
+            << ", \"thread_tiles\": [" << joinValues(r.threadTiles, ", ") << "]}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+}
+
+std::vector<std::string> parseStringList(const std::string& text, char separator) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, separator)) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+std::vector<int> parseIntList(const std::string& text) {
+    std::vector<int> values;
+    for (const auto& item : parseStringList(text)) {
+        values.push_back(std::stoi(item));
+    }
+    return values;
+}
+
+std::vector<std::pair<int, int>> parseSizeList(const std::string& text) {
+    std::vector<std::pair<int, int>> sizes;
+    for (const auto& item : parseStringList(text)) {
+        size_t split = item.find('x');
+        int width = std::stoi(item.substr(0, split));
+        int height = (split == std::string::npos) ? width : std::stoi(item.substr(split + 1));
+        sizes.push_back({width, height});
+    }
+    return sizes;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// One row of headless benchmark output: a single engine/size/thread-count run
+struct BenchmarkResult {
+    std::string engine;
+    std::string rule = "B3/S23";
+    int width = 0;
+    int height = 0;
+    int threads = 0;
+    std::string schedule = "-";       // block schedule of the THRD/OMP engines
+    int tileWidth = 0;
+    int tileHeight = 0;
+    int generations = 0;              // timed steps
+    long long generationsPerStep = 1; // more than one for engines that leap ahead, e.g. Hashlife
+    unsigned int seed = 0;
+    double totalMicros = 0;
+    double meanMicros = 0;
+    double minMicros = 0;
+    double p50Micros = 0;
+    double p90Micros = 0;
+    double p99Micros = 0;
+    double maxMicros = 0;
+    double cellsPerSecond = 0;
+    long long finalPopulation = 0; // identical across the bounded-grid engines for the same seed
+
+    // Per-thread busy time and blocks processed over the whole run (THRD/OMP only).
+    // Balanced busy times with flat scaling point at memory bandwidth, not partitioning.
+    std::vector<double> threadBusyMicros;
+    std::vector<long long> threadTiles;
+    long long steals = 0;
+};
+
+// Slowest thread's busy time over the mean, 1.0 when perfectly balanced
+double loadImbalance(const BenchmarkResult& result);
+
+// Fill in the timing fields of result from per-step samples (microseconds)
+void summarizeGenerations(BenchmarkResult& result, std::vector<double> generationMicros);
+
+void writeBenchmarkCsv(std::ostream& out, const std::vector<BenchmarkResult>& results);
+void writeBenchmarkJson(std::ostream& out, const std::vector<BenchmarkResult>& results);
+
+// Parse sweep lists from the command line, e.g. "1,2,4,8" and "256x256,1024x768"
+std::vector<int> parseIntList(const std::string& text);
+std::vector<std::string> parseStringList(const std::string& text, char separator = ',');
+std::vector<std::pair<int, int>> parseSizeList(const std::string& text);
@@ -0,0 +1,194 @@
+#include "BitGrid.h"
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BITGRID_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Every backend exposes the same handful of operations on a "vector" of
+// 64-bit words, so the adder network below is written only once.
+struct ScalarOps {
+    using V = uint64_t;
+    static const int lanes = 1;
+    static const char* name() { return "scalar"; }
+    static V load(const uint64_t* p) { return *p; }
+    static void store(uint64_t* p, V v) { *p = v; }
+    static V bitAnd(V a, V b) { return a & b; }
+    static V bitOr(V a, V b) { return a | b; }
+    static V bitXor(V a, V b) { return a ^ b; }
+    static V andNot(V a, V b) { return ~a & b; }
+    static V shl1(V a) { return a << 1; }
+    static V shr1(V a) { return a >> 1; }
+    static V shl63(V a) { return a << 63; }
+    static V shr63(V a) { return a >> 63; }
+};
+
+#if defined(__AVX2__)
+struct SimdOps {
+    using V = __m256i;
+    static const int lanes = 4;
+    static const char* name() { return "AVX2"; }
+    static V load(const uint64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(uint64_t* p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static V bitAnd(V a, V b) { return _mm256_and_si256(a, b); }
+    static V bitOr(V a, V b) { return _mm256_or_si256(a, b); }
+    static V bitXor(V a, V b) { return _mm256_xor_si256(a, b); }
+    static V andNot(V a, V b) { return _mm256_andnot_si256(a, b); }
+    static V shl1(V a) { return _mm256_slli_epi64(a, 1); }
+    static V shr1(V a) { return _mm256_srli_epi64(a, 1); }
+    static V shl63(V a) { return _mm256_slli_epi64(a, 63); }
+    static V shr63(V a) { return _mm256_srli_epi64(a, 63); }
+};
+#elif defined(BITGRID_SSE2)
+struct SimdOps {
+    using V = __m128i;
+    static const int lanes = 2;
+    static const char* name() { return "SSE2"; }
+    static V load(const uint64_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(uint64_t* p, V v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static V bitAnd(V a, V b) { return _mm_and_si128(a, b); }
+    static V bitOr(V a, V b) { return _mm_or_si128(a, b); }
+    static V bitXor(V a, V b) { return _mm_xor_si128(a, b); }
+    static V andNot(V a, V b) { return _mm_andnot_si128(a, b); }
+    static V shl1(V a) { return _mm_slli_epi64(a, 1); }
+    static V shr1(V a) { return _mm_srli_epi64(a, 1); }
+    static V shl63(V a) { return _mm_slli_epi64(a, 63); }
+    static V shr63(V a) { return _mm_srli_epi64(a, 63); }
+};
+#else
+using SimdOps = ScalarOps;
+#endif
+
+// Widest vector we ever use, in words; rows are padded to a multiple of it
+const int kMaxLanes = 4;
+
+// Compute one output row. Bit x of a word is cell x % 64 of that word, so the
+// west neighbour of every cell is the row shifted left by one with the top bit
+// of the previous word carried in, and the east neighbour is the mirror image.
+template <typename Ops>
+void stepRow(const uint64_t* above, const uint64_t* mid, const uint64_t* below, uint64_t* out, int words) {
+    using V = typename Ops::V;
+    for (int i = 0; i < words; i += Ops::lanes) {
+        V a = Ops::load(above + i);
+        V m = Ops::load(mid + i);
+        V b = Ops::load(below + i);
+
+        V aw = Ops::bitOr(Ops::shl1(a), Ops::shr63(Ops::load(above + i - 1)));
+        V ae = Ops::bitOr(Ops::shr1(a), Ops::shl63(Ops::load(above + i + 1)));
+        V mw = Ops::bitOr(Ops::shl1(m), Ops::shr63(Ops::load(mid + i - 1)));
+        V me = Ops::bitOr(Ops::shr1(m), Ops::shl63(Ops::load(mid + i + 1)));
+        V bw = Ops::bitOr(Ops::shl1(b), Ops::shr63(Ops::load(below + i - 1)));
+        V be = Ops::bitOr(Ops::shr1(b), Ops::shl63(Ops::load(below + i + 1)));
+
+        // Full adders over each row: sum bit and carry (twos) bit
+        V awa = Ops::bitXor(aw, a);
+        V aSum = Ops::bitXor(awa, ae);
+        V aCarry = Ops::bitOr(Ops::bitAnd(aw, a), Ops::bitAnd(ae, awa));
+        V bwb = Ops::bitXor(bw, b);
+        V bSum = Ops::bitXor(bwb, be);
+        V bCarry = Ops::bitOr(Ops::bitAnd(bw, b), Ops::bitAnd(be, bwb));
+        V mSum = Ops::bitXor(mw, me);
+        V mCarry = Ops::bitAnd(mw, me);
+
+        // Add the three ones bits, giving the final ones bit and one more twos bit
+        V ab = Ops::bitXor(aSum, bSum);
+        V ones = Ops::bitXor(ab, mSum);
+        V onesCarry = Ops::bitOr(Ops::bitAnd(aSum, bSum), Ops::bitAnd(mSum, ab));
+
+        // A live result needs exactly one of the four twos bits set
+        V u = Ops::bitXor(aCarry, bCarry);
+        V v = Ops::bitAnd(aCarry, bCarry);
+        V w = Ops::bitXor(mCarry, onesCarry);
+        V z = Ops::bitAnd(mCarry, onesCarry);
+        V exactlyOneTwo = Ops::andNot(Ops::bitOr(v, z), Ops::bitXor(u, w));
+
+        // 3 neighbours always lives, 2 neighbours keeps a live cell alive
+        Ops::store(out + i, Ops::bitAnd(exactlyOneTwo, Ops::bitOr(ones, m)));
+    }
+}
+
+} // namespace
+
+BitGrid::BitGrid(int width, int height)
+    : m_width(width), m_height(height) {
+    m_words = (width + 63) / 64;
+    m_paddedWords = (m_words + kMaxLanes - 1) / kMaxLanes * kMaxLanes;
+    m_stride = m_paddedWords + 2;
+    m_tailMask = (width % 64 == 0) ? ~0ULL : (1ULL << (width % 64)) - 1;
+    m_front.assign(static_cast<size_t>(m_stride) * (height + 2), 0);
+    m_back.assign(m_front.size(), 0);
+}
+
+const uint64_t* BitGrid::row(const std::vector<uint64_t>& buffer, int y) const {
+    return buffer.data() + static_cast<size_t>(y + 1) * m_stride + 1;
+}
+
+uint64_t* BitGrid::row(std::vector<uint64_t>& buffer, int y) {
+    return buffer.data() + static_cast<size_t>(y + 1) * m_stride + 1;
+}
+
+void BitGrid::pack(const std::vector<std::vector<int>>& grid) {
+    std::fill(m_front.begin(), m_front.end(), 0);
+    for (int y = 0; y < m_height; ++y) {
+        uint64_t* dst = row(m_front, y);
+        for (int x = 0; x < m_width; ++x) {
+            if (grid[y][x]) dst[x >> 6] |= 1ULL << (x & 63);
+        }
+    }
+}
+
+void BitGrid::unpack(std::vector<std::vector<int>>& grid) const {
+    for (int y = 0; y < m_height; ++y) {
+        const uint64_t* src = row(m_front, y);
+        for (int x = 0; x < m_width; ++x) {
+            grid[y][x] = static_cast<int>((src[x >> 6] >> (x & 63)) & 1);
+        }
+    }
+}
+
+bool BitGrid::get(int x, int y) const {
+    return (row(m_front, y)[x >> 6] >> (x & 63)) & 1;
+}
+
+void BitGrid::set(int x, int y, bool alive) {
+    uint64_t& word = row(m_front, y)[x >> 6];
+    uint64_t bit = 1ULL << (x & 63);
+    word = alive ? (word | bit) : (word & ~bit);
+}
+
+void BitGrid::step() {
+    for (int y = 0; y < m_height; ++y) {
+        uint64_t* out = row(m_back, y);
+        stepRow<SimdOps>(row(m_front, y - 1), row(m_front, y), row(m_front, y + 1), out, m_paddedWords);
+
+        // Cells past the right edge must stay dead or they would feed back next generation
+        out[m_words - 1] &= m_tailMask;
+        std::fill(out + m_words, out + m_paddedWords, 0);
+    }
+    m_front.swap(m_back);
+}
+
+long long BitGrid::population() const {
+    long long count = 0;
+    for (int y = 0; y < m_height; ++y) {
+        const uint64_t* src = row(m_front, y);
+        for (int i = 0; i < m_words; ++i) {
+            uint64_t word = src[i];
+            while (word) {
+                word &= word - 1;
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+const char* BitGrid::backendName() {
+    return SimdOps::name();
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Game of Life grid that stores one cell per bit, 64 cells to a word.
+// Every row carries a zero word on each side and the grid carries a zero row
+// above and below, so the step kernel never has to bounds-check a neighbour.
+// Cells outside the grid are dead, exactly like countLiveNeighbors.
+class BitGrid {
+public:
+    BitGrid(int width, int height);
+
+    // Copy cells to and from the regular vector-of-rows representation
+    void pack(const std::vector<std::vector<int>>& grid);
+    void unpack(std::vector<std::vector<int>>& grid) const;
+
+    bool get(int x, int y) const;
+    void set(int x, int y, bool alive);
+
+    // Advance one generation using bit-parallel adders
+    void step();
+
+    long long population() const;
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+    // Name of the instruction set the step kernel was compiled for
+    static const char* backendName();
+
+private:
+    const uint64_t* row(const std::vector<uint64_t>& buffer, int y) const;
+    uint64_t* row(std::vector<uint64_t>& buffer, int y);
+
+    int m_width;
+    int m_height;
+    int m_words;         // words holding cells in each row
+    int m_paddedWords;   // m_words rounded up to a whole number of vector lanes
+    int m_stride;        // m_paddedWords plus one guard word on each side
+    uint64_t m_tailMask; // valid bits of the last word in a row
+    std::vector<uint64_t> m_front;
+    std::vector<uint64_t> m_back;
+};
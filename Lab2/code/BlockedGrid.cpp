@@ -0,0 +1,230 @@
+#include "BlockedGrid.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+const int kCacheLine = 64;
+
+uint64_t packRange(uint32_t next, uint32_t end) {
+    return (static_cast<uint64_t>(end) << 32) | next;
+}
+
+} // namespace
+
+BlockedGrid::BlockedGrid(int width, int height, int tileSize, Schedule schedule, int maxThreads, const Rule& rule)
+    : m_rule(rule), m_border(rule.range), m_width(width), m_height(height), m_schedule(schedule), m_activeThreads(0),
+      m_nextTile(0), m_bands(std::max(maxThreads, 1)), m_stats(std::max(maxThreads, 1)),
+      m_columnSums(std::max(maxThreads, 1)) {
+    // Block widths are whole cache lines; heights are whatever was asked for
+    tileSize = std::max(tileSize, 1);
+    m_tileWidth = (tileSize + kCacheLine - 1) / kCacheLine * kCacheLine;
+    m_tileHeight = tileSize;
+    m_tilesX = (width + m_tileWidth - 1) / m_tileWidth;
+    m_tileCount = m_tilesX * ((height + m_tileHeight - 1) / m_tileHeight);
+
+    // Room for the left pad, the cells and the right ghost columns, in whole cache lines
+    m_leftPad = (m_border + kCacheLine - 1) / kCacheLine * kCacheLine;
+    m_stride = (m_leftPad + width + m_border + kCacheLine - 1) / kCacheLine * kCacheLine;
+    size_t bytes = static_cast<size_t>(m_stride) * (height + 2 * m_border) + kCacheLine;
+    m_front.assign(bytes, 0);
+    m_back.assign(bytes, 0);
+
+    if (m_rule.family == Rule::Family::LargerThanLife) {
+        for (auto& sums : m_columnSums) {
+            sums.resize(m_tileWidth + 2 * m_border);
+        }
+    }
+}
+
+size_t BlockedGrid::alignOffset(const uint8_t* data) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(data);
+    return (kCacheLine - address % kCacheLine) % kCacheLine;
+}
+
+void BlockedGrid::load(const std::vector<std::vector<int>>& grid) {
+    uint8_t* front = cells(m_front);
+    for (int y = 0; y < m_height; ++y) {
+        for (int x = 0; x < m_width; ++x) {
+            int state = grid[y][x];
+            front[index(x, y)] = static_cast<uint8_t>(state > 0 && state < m_rule.states ? state : 0);
+        }
+    }
+}
+
+void BlockedGrid::unpack(std::vector<std::vector<int>>& grid) const {
+    const uint8_t* front = cells(m_front);
+    for (int y = 0; y < m_height; ++y) {
+        for (int x = 0; x < m_width; ++x) {
+            grid[y][x] = front[index(x, y)];
+        }
+    }
+}
+
+void BlockedGrid::beginGeneration(int numThreads) {
+    m_activeThreads = std::min(std::max(numThreads, 1), static_cast<int>(m_bands.size()));
+    m_nextTile.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < m_activeThreads; ++i) {
+        uint32_t begin = static_cast<uint32_t>(static_cast<long long>(m_tileCount) * i / m_activeThreads);
+        uint32_t end = static_cast<uint32_t>(static_cast<long long>(m_tileCount) * (i + 1) / m_activeThreads);
+        m_bands[i].range.store(packRange(begin, end), std::memory_order_relaxed);
+    }
+}
+
+void BlockedGrid::endGeneration() {
+    m_front.swap(m_back);
+}
+
+void BlockedGrid::resetStats() {
+    for (auto& stats : m_stats) {
+        stats = WorkerStats();
+    }
+}
+
+// Take the next block from the front of this thread's own band
+bool BlockedGrid::claimOwn(int thread, int& tile) {
+    std::atomic<uint64_t>& range = m_bands[thread].range;
+    uint64_t current = range.load(std::memory_order_relaxed);
+    while (true) {
+        uint32_t next = static_cast<uint32_t>(current);
+        uint32_t end = static_cast<uint32_t>(current >> 32);
+        if (next >= end) return false;
+        if (range.compare_exchange_weak(current, packRange(next + 1, end), std::memory_order_relaxed)) {
+            tile = static_cast<int>(next);
+            return true;
+        }
+    }
+}
+
+// Take a block from the back of another thread's band, trying each victim once
+bool BlockedGrid::steal(int thread, int& tile) {
+    for (int offset = 1; offset < m_activeThreads; ++offset) {
+        std::atomic<uint64_t>& range = m_bands[(thread + offset) % m_activeThreads].range;
+        uint64_t current = range.load(std::memory_order_relaxed);
+        while (true) {
+            uint32_t next = static_cast<uint32_t>(current);
+            uint32_t end = static_cast<uint32_t>(current >> 32);
+            if (next >= end) break;
+            if (range.compare_exchange_weak(current, packRange(next, end - 1), std::memory_order_relaxed)) {
+                tile = static_cast<int>(end - 1);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void BlockedGrid::runWorker(int thread) {
+    auto start = std::chrono::high_resolution_clock::now();
+    WorkerStats& stats = m_stats[thread];
+    int tile;
+
+    if (m_schedule == Schedule::Dynamic) {
+        while ((tile = m_nextTile.fetch_add(1, std::memory_order_relaxed)) < m_tileCount) {
+            processTile(thread, tile);
+            stats.tiles++;
+        }
+    } else {
+        while (claimOwn(thread, tile)) {
+            processTile(thread, tile);
+            stats.tiles++;
+        }
+        if (m_schedule == Schedule::Stealing) {
+            while (steal(thread, tile)) {
+                processTile(thread, tile);
+                stats.tiles++;
+                stats.steals++;
+            }
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    stats.busyMicros += std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+void BlockedGrid::processTile(int thread, int tile) {
+    int x0 = (tile % m_tilesX) * m_tileWidth;
+    int y0 = (tile / m_tilesX) * m_tileHeight;
+    int x1 = std::min(x0 + m_tileWidth, m_width);
+    int y1 = std::min(y0 + m_tileHeight, m_height);
+
+    withKernel(m_rule, [&](const auto& kernel) { stepTile(kernel, thread, x0, y0, x1, y1); });
+}
+
+// Range-1 rules: add up the eight neighbours directly
+template <typename Kernel>
+void BlockedGrid::stepTile(const Kernel& kernel, int, int x0, int y0, int x1, int y1) {
+    const uint8_t* src = cells(m_front);
+    uint8_t* dst = cells(m_back);
+    for (int y = y0; y < y1; ++y) {
+        const uint8_t* above = src + index(0, y - 1);
+        const uint8_t* row = src + index(0, y);
+        const uint8_t* below = src + index(0, y + 1);
+        uint8_t* out = dst + index(0, y);
+        for (int x = x0; x < x1; ++x) {
+            int liveNeighbors = Kernel::live(above[x - 1]) + Kernel::live(above[x]) + Kernel::live(above[x + 1])
+                              + Kernel::live(row[x - 1]) + Kernel::live(row[x + 1])
+                              + Kernel::live(below[x - 1]) + Kernel::live(below[x]) + Kernel::live(below[x + 1]);
+            out[x] = kernel.next(row[x], liveNeighbors);
+        }
+    }
+}
+
+// Larger than Life: keep a running sum of live cells down each column of the
+// neighbourhood, updated by one row in and one row out per output row, then
+// slide a window of 2R+1 column sums along the row. The cost per cell no
+// longer depends on the range.
+void BlockedGrid::stepTile(const LargerThanLifeKernel& kernel, int thread, int x0, int y0, int x1, int y1) {
+    const uint8_t* src = cells(m_front);
+    uint8_t* dst = cells(m_back);
+    int r = m_border;
+    int* columns = m_columnSums[thread].data(); // columns[i] sums column x0 - r + i
+    int count = x1 - x0 + 2 * r;
+
+    for (int i = 0; i < count; ++i) {
+        int sum = 0;
+        for (int dy = -r; dy <= r; ++dy) {
+            sum += LargerThanLifeKernel::live(src[index(x0 - r + i, y0 + dy)]);
+        }
+        columns[i] = sum;
+    }
+
+    for (int y = y0; y < y1; ++y) {
+        if (y > y0) {
+            const uint8_t* entering = src + index(x0 - r, y + r);
+            const uint8_t* leaving = src + index(x0 - r, y - r - 1);
+            for (int i = 0; i < count; ++i) {
+                columns[i] += LargerThanLifeKernel::live(entering[i]) - LargerThanLifeKernel::live(leaving[i]);
+            }
+        }
+
+        const uint8_t* row = src + index(0, y);
+        uint8_t* out = dst + index(0, y);
+        int window = 0;
+        for (int i = 0; i < 2 * r; ++i) {
+            window += columns[i];
+        }
+        int centre = kernel.countCentre() ? 0 : 1;
+        for (int x = x0; x < x1; ++x) {
+            int i = x - x0;
+            window += columns[i + 2 * r];
+            out[x] = kernel.next(row[x], window - centre * LargerThanLifeKernel::live(row[x]));
+            window -= columns[i];
+        }
+    }
+}
+
+BlockedGrid::Schedule BlockedGrid::parseSchedule(const std::string& name) {
+    if (name == "dynamic") return Schedule::Dynamic;
+    if (name == "steal") return Schedule::Stealing;
+    return Schedule::Static;
+}
+
+const char* BlockedGrid::scheduleName(Schedule schedule) {
+    switch (schedule) {
+        case Schedule::Dynamic: return "dynamic";
+        case Schedule::Stealing: return "steal";
+        default: return "static";
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Rule.h"
+
+// Busy time and work done by one thread since the last resetStats(). Each
+// entry sits on its own cache line so threads never contend updating them.
+struct alignas(64) WorkerStats {
+    double busyMicros = 0;
+    long long tiles = 0;
+    long long steals = 0;
+};
+
+// Dense Game of Life grid split into cache-sized 2D blocks for the THRD and
+// OMP engines. Cells are byte states in two flat buffers with a dead ghost
+// border as wide as the rule's neighbourhood; every row starts on a 64-byte
+// boundary and block widths are whole cache lines, so two threads never write
+// the same line of the back buffer. Blocks only read the ghost rows and
+// columns around them from the front buffer. Each block runs the kernel that
+// withKernel() picks for the rule.
+//
+// One generation is beginGeneration(), then runWorker(i) on each of the
+// threads, then endGeneration() once they have all returned. How blocks are
+// handed out depends on the schedule:
+//   Static:   each thread takes a fixed contiguous band of blocks.
+//   Dynamic:  threads pull the next block from a shared counter.
+//   Stealing: threads start on their static band and, once it is empty,
+//             steal blocks from the far end of other threads' bands.
+class BlockedGrid {
+public:
+    enum class Schedule { Static, Dynamic, Stealing };
+
+    BlockedGrid(int width, int height, int tileSize, Schedule schedule, int maxThreads, const Rule& rule);
+
+    BlockedGrid(const BlockedGrid&) = delete;
+    BlockedGrid& operator=(const BlockedGrid&) = delete;
+
+    // Copy cells to and from the regular vector-of-rows representation
+    void load(const std::vector<std::vector<int>>& grid);
+    void unpack(std::vector<std::vector<int>>& grid) const;
+
+    void beginGeneration(int numThreads);
+    void runWorker(int thread);
+    void endGeneration();
+
+    const std::vector<WorkerStats>& stats() const { return m_stats; }
+    void resetStats();
+
+    Schedule schedule() const { return m_schedule; }
+    int tileWidth() const { return m_tileWidth; }
+    int tileHeight() const { return m_tileHeight; }
+
+    // "static", "dynamic" or "steal"; anything else selects Static
+    static Schedule parseSchedule(const std::string& name);
+    static const char* scheduleName(Schedule schedule);
+
+private:
+    // A thread's remaining band of blocks, [next, end) packed in one word so
+    // the owner and thieves can both claim blocks with a single CAS
+    struct alignas(64) Band {
+        std::atomic<uint64_t> range{0};
+    };
+
+    // The buffers are over-allocated by one cache line and used from the first aligned byte
+    static size_t alignOffset(const uint8_t* data);
+    uint8_t* cells(std::vector<uint8_t>& buffer) const { return buffer.data() + alignOffset(buffer.data()); }
+    const uint8_t* cells(const std::vector<uint8_t>& buffer) const { return buffer.data() + alignOffset(buffer.data()); }
+    size_t index(int x, int y) const { return static_cast<size_t>(y + m_border) * m_stride + m_leftPad + x; }
+
+    bool claimOwn(int thread, int& tile);
+    bool steal(int thread, int& tile);
+    void processTile(int thread, int tile);
+
+    // Step the cells [x0, x1) x [y0, y1); overloaded on the kernel type
+    template <typename Kernel>
+    void stepTile(const Kernel& kernel, int thread, int x0, int y0, int x1, int y1);
+    void stepTile(const LargerThanLifeKernel& kernel, int thread, int x0, int y0, int x1, int y1);
+
+    Rule m_rule;
+    int m_border;  // ghost cells on each side, the rule's range
+    int m_leftPad; // the left border rounded up so cell 0 of every row starts a cache line
+    int m_width;
+    int m_height;
+    int m_stride;
+    int m_tileWidth;
+    int m_tileHeight;
+    int m_tilesX;
+    int m_tileCount;
+    Schedule m_schedule;
+    int m_activeThreads;
+
+    std::vector<uint8_t> m_front;
+    std::vector<uint8_t> m_back;
+
+    std::atomic<int> m_nextTile;
+    std::vector<Band> m_bands;
+    std::vector<WorkerStats> m_stats;
+    std::vector<std::vector<int>> m_columnSums; // per-thread scratch for Larger than Life
+};
@@ -0,0 +1,94 @@
+#include "GridRenderer.h"
+
+#include <iostream>
+
+GridRenderer::GridRenderer(int gridWidth, int gridHeight, int cellSize, Mode mode)
+    : m_gridWidth(gridWidth), m_gridHeight(gridHeight), m_cellSize(cellSize), m_mode(mode),
+      m_vertices(sf::Quads) {
+    if (m_mode == Mode::Texture) {
+        unsigned int maxSize = sf::Texture::getMaximumSize();
+        if (static_cast<unsigned int>(gridWidth) > maxSize || static_cast<unsigned int>(gridHeight) > maxSize ||
+            !m_texture.create(gridWidth, gridHeight)) {
+            std::cerr << "Grid does not fit in one texture, drawing vertices instead." << std::endl;
+            m_mode = Mode::Vertices;
+        } else {
+            m_texture.setSmooth(false);
+            m_sprite.setTexture(m_texture, true);
+            m_sprite.setScale(static_cast<float>(cellSize), static_cast<float>(cellSize));
+            // Alpha stays opaque; only the colour channels change per frame
+            m_pixels.assign(static_cast<size_t>(gridWidth) * gridHeight * 4, 255);
+        }
+    }
+}
+
+void GridRenderer::draw(sf::RenderTarget& target, const std::vector<std::vector<int>>& grid) {
+    if (m_mode == Mode::Texture) {
+        drawTexture(target, grid);
+    } else if (m_mode == Mode::Vertices) {
+        drawVertices(target, grid);
+    } else {
+        drawShapes(target, grid);
+    }
+}
+
+void GridRenderer::drawTexture(sf::RenderTarget& target, const std::vector<std::vector<int>>& grid) {
+    sf::Uint8* pixel = m_pixels.data();
+    for (int y = 0; y < m_gridHeight; ++y) {
+        const std::vector<int>& row = grid[y];
+        for (int x = 0; x < m_gridWidth; ++x, pixel += 4) {
+            // Dying cells of multi-state rules are drawn as dead, as in the other modes
+            sf::Uint8 value = row[x] == 1 ? 255 : 0;
+            pixel[0] = value;
+            pixel[1] = value;
+            pixel[2] = value;
+        }
+    }
+    m_texture.update(m_pixels.data());
+    target.draw(m_sprite);
+}
+
+void GridRenderer::drawVertices(sf::RenderTarget& target, const std::vector<std::vector<int>>& grid) {
+    // clear() keeps the capacity, so steady-state frames do not allocate
+    m_vertices.clear();
+    float size = static_cast<float>(m_cellSize);
+    for (int y = 0; y < m_gridHeight; ++y) {
+        for (int x = 0; x < m_gridWidth; ++x) {
+            if (grid[y][x] == 1) {
+                float left = x * size;
+                float top = y * size;
+                m_vertices.append(sf::Vertex(sf::Vector2f(left, top), sf::Color::White));
+                m_vertices.append(sf::Vertex(sf::Vector2f(left + size, top), sf::Color::White));
+                m_vertices.append(sf::Vertex(sf::Vector2f(left + size, top + size), sf::Color::White));
+                m_vertices.append(sf::Vertex(sf::Vector2f(left, top + size), sf::Color::White));
+            }
+        }
+    }
+    target.draw(m_vertices);
+}
+
+void GridRenderer::drawShapes(sf::RenderTarget& target, const std::vector<std::vector<int>>& grid) {
+    sf::RectangleShape cellShape(sf::Vector2f(m_cellSize, m_cellSize));
+    cellShape.setFillColor(sf::Color::White);
+    for (int y = 0; y < m_gridHeight; ++y) {
+        for (int x = 0; x < m_gridWidth; ++x) {
+            if (grid[y][x] == 1) {
+                cellShape.setPosition(x * m_cellSize, y * m_cellSize);
+                target.draw(cellShape);
+            }
+        }
+    }
+}
+
+GridRenderer::Mode GridRenderer::parseMode(const std::string& name) {
+    if (name == "vertices") return Mode::Vertices;
+    if (name == "shapes") return Mode::Shapes;
+    return Mode::Texture;
+}
+
+const char* GridRenderer::modeName(Mode mode) {
+    switch (mode) {
+        case Mode::Vertices: return "vertices";
+        case Mode::Shapes: return "shapes";
+        default: return "texture";
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+
+// Draws the whole grid in a single draw call instead of one RectangleShape per
+// live cell.
+//   Texture:  one texel per cell, uploaded with sf::Texture::update and drawn
+//             as a single sprite scaled up by the cell size.
+//   Vertices: one quad per live cell in a reused sf::VertexArray.
+//   Shapes:   the original per-cell RectangleShape path, kept for comparison.
+class GridRenderer {
+public:
+    enum class Mode { Texture, Vertices, Shapes };
+
+    GridRenderer(int gridWidth, int gridHeight, int cellSize, Mode mode);
+
+    // Upload the current generation and draw it; does not clear or display
+    void draw(sf::RenderTarget& target, const std::vector<std::vector<int>>& grid);
+
+    Mode mode() const { return m_mode; }
+
+    // "texture", "vertices" or "shapes"; anything else selects Texture
+    static Mode parseMode(const std::string& name);
+    static const char* modeName(Mode mode);
+
+private:
+    void drawTexture(sf::RenderTarget& target, const std::vector<std::vector<int>>& grid);
+    void drawVertices(sf::RenderTarget& target, const std::vector<std::vector<int>>& grid);
+    void drawShapes(sf::RenderTarget& target, const std::vector<std::vector<int>>& grid);
+
+    int m_gridWidth;
+    int m_gridHeight;
+    int m_cellSize;
+    Mode m_mode;
+
+    std::vector<sf::Uint8> m_pixels; // RGBA, one pixel per cell
+    sf::Texture m_texture;
+    sf::Sprite m_sprite;
+    sf::VertexArray m_vertices;
+};
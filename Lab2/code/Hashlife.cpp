@@ -0,0 +1,554 @@
+#include "Hashlife.h"
+#include "PatternIO.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+
+// The root must stay small enough for cell coordinates to fit in a long long
+const int kMaxLevel = 62;
+const int kMaxStepExponent = kMaxLevel - 4;
+
+// Rounds towards minus infinity, unlike /
+long long floorToMultiple(long long value, long long multiple) {
+    long long result = value / multiple * multiple;
+    return result > value ? result - multiple : result;
+}
+
+} // namespace
+
+Hashlife::Hashlife(size_t maxNodes)
+    : m_maxNodes(std::max<size_t>(maxNodes, 1024)), m_stepExponent(0), m_generation(0) {
+    // Nodes 0 and 1 are the dead and live leaves and are never collected
+    m_nodes.push_back({kNone, kNone, kNone, kNone, kNone, kNone, 0, 0});
+    m_nodes.push_back({kNone, kNone, kNone, kNone, kNone, kNone, 0, 1});
+    m_buckets.assign(1 << 16, kNone);
+    m_empty.push_back(leaf(false));
+    m_root = emptyNode(3);
+}
+
+size_t Hashlife::hashOf(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) const {
+    size_t h = nw;
+    h = h * 1000003u + ne;
+    h = h * 1000003u + sw;
+    h = h * 1000003u + se;
+    return (h ^ (h >> 17)) & (m_buckets.size() - 1);
+}
+
+uint32_t Hashlife::join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) {
+    size_t bucket = hashOf(nw, ne, sw, se);
+    for (uint32_t i = m_buckets[bucket]; i != kNone; i = m_nodes[i].next) {
+        const Node& n = m_nodes[i];
+        if (n.nw == nw && n.ne == ne && n.sw == sw && n.se == se) return i;
+    }
+
+    Node node;
+    node.nw = nw;
+    node.ne = ne;
+    node.sw = sw;
+    node.se = se;
+    node.result = kNone;
+    node.next = m_buckets[bucket];
+    node.level = m_nodes[nw].level + 1;
+    node.population = m_nodes[nw].population + m_nodes[ne].population + m_nodes[sw].population + m_nodes[se].population;
+
+    uint32_t index;
+    if (!m_freeList.empty()) {
+        index = m_freeList.back();
+        m_freeList.pop_back();
+        m_nodes[index] = node;
+    } else {
+        index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.push_back(node);
+    }
+    m_buckets[bucket] = index;
+
+    // Keep chains short; rehashing never moves nodes, so indices stay valid
+    if (nodeCount() > m_buckets.size()) rehash(m_buckets.size() * 2);
+    return index;
+}
+
+void Hashlife::rehash(size_t buckets) {
+    m_buckets.assign(buckets, kNone);
+    std::vector<uint8_t> isFree(m_nodes.size(), 0);
+    for (uint32_t index : m_freeList) isFree[index] = 1;
+    for (uint32_t i = 2; i < m_nodes.size(); ++i) {
+        if (isFree[i]) continue;
+        Node& n = m_nodes[i];
+        size_t bucket = hashOf(n.nw, n.ne, n.sw, n.se);
+        n.next = m_buckets[bucket];
+        m_buckets[bucket] = i;
+    }
+}
+
+uint32_t Hashlife::emptyNode(int level) {
+    while (static_cast<int>(m_empty.size()) <= level) {
+        uint32_t e = m_empty.back();
+        m_empty.push_back(join(e, e, e, e));
+    }
+    return m_empty[level];
+}
+
+uint32_t Hashlife::centre(uint32_t node) {
+    Node n = m_nodes[node];
+    return join(m_nodes[n.nw].se, m_nodes[n.ne].sw, m_nodes[n.sw].ne, m_nodes[n.se].nw);
+}
+
+// Level 2 node (4x4 cells): the centre 2x2 one generation later
+uint32_t Hashlife::baseSuccessor(uint32_t node) {
+    const Node& n = m_nodes[node];
+    int cells[4][4];
+    const uint32_t quadrants[2][2] = {{n.nw, n.ne}, {n.sw, n.se}};
+    for (int qy = 0; qy < 2; ++qy) {
+        for (int qx = 0; qx < 2; ++qx) {
+            const Node& q = m_nodes[quadrants[qy][qx]];
+            cells[qy * 2][qx * 2] = q.nw;
+            cells[qy * 2][qx * 2 + 1] = q.ne;
+            cells[qy * 2 + 1][qx * 2] = q.sw;
+            cells[qy * 2 + 1][qx * 2 + 1] = q.se;
+        }
+    }
+
+    uint32_t next[2][2];
+    for (int y = 1; y <= 2; ++y) {
+        for (int x = 1; x <= 2; ++x) {
+            int liveNeighbors = cells[y - 1][x - 1] + cells[y - 1][x] + cells[y - 1][x + 1]
+                              + cells[y][x - 1] + cells[y][x + 1]
+                              + cells[y + 1][x - 1] + cells[y + 1][x] + cells[y + 1][x + 1];
+            next[y - 1][x - 1] = leaf(liveNeighbors == 3 || (cells[y][x] && liveNeighbors == 2));
+        }
+    }
+    return join(next[0][0], next[0][1], next[1][0], next[1][1]);
+}
+
+// Centre half of node advanced 2^exponent generations (exponent <= level - 2).
+// The node is split into nine overlapping sub-squares; when the full step is
+// wanted, each is advanced half way, and the four recombined quarters are
+// advanced the other half. Smaller steps skip the first half.
+uint32_t Hashlife::successor(uint32_t node, int exponent) {
+    const Node& n = m_nodes[node];
+    if (n.result != kNone) return n.result;
+    if (n.population == 0) return m_nodes[node].nw;
+
+    int level = n.level;
+    uint32_t result;
+    if (level == 2) {
+        result = baseSuccessor(node);
+    } else {
+        // 4x4 grid of grandchildren
+        uint32_t g[4][4];
+        const uint32_t quadrants[2][2] = {{n.nw, n.ne}, {n.sw, n.se}};
+        for (int qy = 0; qy < 2; ++qy) {
+            for (int qx = 0; qx < 2; ++qx) {
+                const Node& q = m_nodes[quadrants[qy][qx]];
+                g[qy * 2][qx * 2] = q.nw;
+                g[qy * 2][qx * 2 + 1] = q.ne;
+                g[qy * 2 + 1][qx * 2] = q.sw;
+                g[qy * 2 + 1][qx * 2 + 1] = q.se;
+            }
+        }
+
+        bool fullStep = (exponent >= level - 2);
+        int innerExponent = fullStep ? level - 3 : exponent;
+
+        uint32_t t[3][3];
+        for (int y = 0; y < 3; ++y) {
+            for (int x = 0; x < 3; ++x) {
+                uint32_t sub = join(g[y][x], g[y][x + 1], g[y + 1][x], g[y + 1][x + 1]);
+                t[y][x] = fullStep ? successor(sub, level - 3) : centre(sub);
+            }
+        }
+
+        uint32_t q[2][2];
+        for (int y = 0; y < 2; ++y) {
+            for (int x = 0; x < 2; ++x) {
+                uint32_t quarter = join(t[y][x], t[y][x + 1], t[y + 1][x], t[y + 1][x + 1]);
+                q[y][x] = successor(quarter, innerExponent);
+            }
+        }
+        result = join(q[0][0], q[0][1], q[1][0], q[1][1]);
+    }
+
+    m_nodes[node].result = result;
+    return result;
+}
+
+void Hashlife::expand() {
+    Node r = m_nodes[m_root];
+    uint32_t e = emptyNode(r.level - 1);
+    uint32_t nw = join(e, e, e, r.nw);
+    uint32_t ne = join(e, e, r.ne, e);
+    uint32_t sw = join(e, r.sw, e, e);
+    uint32_t se = join(r.se, e, e, e);
+    m_root = join(nw, ne, sw, se);
+}
+
+// True when every live cell lies in the centre quarter of the root
+bool Hashlife::centreHoldsPattern() const {
+    const Node& r = m_nodes[m_root];
+    double inner = m_nodes[m_nodes[r.nw].se].population + m_nodes[m_nodes[r.ne].sw].population
+                 + m_nodes[m_nodes[r.sw].ne].population + m_nodes[m_nodes[r.se].nw].population;
+    return inner == r.population;
+}
+
+void Hashlife::setStepExponent(int exponent) {
+    exponent = std::min(std::max(exponent, 0), kMaxStepExponent);
+    if (exponent != m_stepExponent) {
+        m_stepExponent = exponent;
+        clearResults();
+    }
+}
+
+void Hashlife::clearResults() {
+    for (auto& node : m_nodes) {
+        node.result = kNone;
+    }
+}
+
+void Hashlife::step() {
+    // Grow until the pattern sits in the centre quarter of a root big enough
+    // for the step, then once more so nothing can reach the edge of the result
+    while (m_nodes[m_root].level < m_stepExponent + 3 || !centreHoldsPattern()) {
+        expand();
+    }
+    expand();
+
+    m_root = successor(m_root, m_stepExponent);
+    m_generation += static_cast<double>(1ULL << m_stepExponent);
+
+    if (nodeCount() > m_maxNodes) collectGarbage();
+}
+
+void Hashlife::mark(uint32_t node, std::vector<uint8_t>& marked, bool keepResults) const {
+    if (node == kNone || marked[node]) return;
+    marked[node] = 1;
+    const Node& n = m_nodes[node];
+    if (n.level == 0) return;
+    mark(n.nw, marked, keepResults);
+    mark(n.ne, marked, keepResults);
+    mark(n.sw, marked, keepResults);
+    mark(n.se, marked, keepResults);
+    if (keepResults) mark(n.result, marked, keepResults);
+}
+
+void Hashlife::collectGarbage() {
+    std::vector<uint8_t> marked(m_nodes.size(), 0);
+    for (uint32_t e : m_empty) mark(e, marked, true);
+    mark(m_root, marked, true);
+
+    // If the cached results alone keep us over half the budget, drop them too
+    size_t live = std::count(marked.begin(), marked.end(), 1);
+    if (live > m_maxNodes / 2) {
+        clearResults();
+        std::fill(marked.begin(), marked.end(), 0);
+        for (uint32_t e : m_empty) mark(e, marked, false);
+        mark(m_root, marked, false);
+    }
+
+    m_freeList.clear();
+    for (uint32_t i = 2; i < m_nodes.size(); ++i) {
+        if (!marked[i]) {
+            m_nodes[i].result = kNone;
+            m_freeList.push_back(i);
+        }
+    }
+    // Drop cached results that point at swept nodes
+    for (auto& node : m_nodes) {
+        if (node.result != kNone && !marked[node.result]) node.result = kNone;
+    }
+    rehash(m_buckets.size());
+}
+
+uint32_t Hashlife::setCell(uint32_t node, long long x, long long y, bool alive) {
+    Node n = m_nodes[node];
+    if (n.level == 0) return leaf(alive);
+    long long half = 1LL << (n.level - 1);
+    if (y < half) {
+        if (x < half) return join(setCell(n.nw, x, y, alive), n.ne, n.sw, n.se);
+        return join(n.nw, setCell(n.ne, x - half, y, alive), n.sw, n.se);
+    }
+    if (x < half) return join(n.nw, n.ne, setCell(n.sw, x, y - half, alive), n.se);
+    return join(n.nw, n.ne, n.sw, setCell(n.se, x - half, y - half, alive));
+}
+
+bool Hashlife::getCell(uint32_t node, long long x, long long y) const {
+    while (true) {
+        const Node& n = m_nodes[node];
+        if (n.population == 0) return false;
+        if (n.level == 0) return true;
+        long long half = 1LL << (n.level - 1);
+        if (y < half) {
+            node = (x < half) ? n.nw : n.ne;
+        } else {
+            node = (x < half) ? n.sw : n.se;
+            y -= half;
+        }
+        if (x >= half) x -= half;
+    }
+}
+
+void Hashlife::setCell(long long x, long long y, bool alive) {
+    while (true) {
+        int level = m_nodes[m_root].level;
+        long long half = 1LL << (level - 1);
+        if ((x >= -half && x < half && y >= -half && y < half) || level >= kMaxLevel) break;
+        expand();
+    }
+    long long half = 1LL << (m_nodes[m_root].level - 1);
+    if (x < -half || x >= half || y < -half || y >= half) return;
+    m_root = setCell(m_root, x + half, y + half, alive);
+}
+
+bool Hashlife::getCell(long long x, long long y) const {
+    long long half = 1LL << (m_nodes[m_root].level - 1);
+    if (x < -half || x >= half || y < -half || y >= half) return false;
+    return getCell(m_root, x + half, y + half);
+}
+
+// Build the node at the given level whose top-left cell is universe (x, y)
+// straight from the grid, bottom-up, so loading costs one join per node
+uint32_t Hashlife::buildRegion(const std::vector<std::vector<int>>& grid, int level, long long x, long long y) {
+    long long height = static_cast<long long>(grid.size());
+    long long width = grid.empty() ? 0 : static_cast<long long>(grid[0].size());
+    long long size = 1LL << level;
+    if (x >= width || y >= height || x + size <= 0 || y + size <= 0) return emptyNode(level);
+    if (level == 0) return leaf(grid[y][x] != 0);
+    long long half = size / 2;
+    uint32_t nw = buildRegion(grid, level - 1, x, y);
+    uint32_t ne = buildRegion(grid, level - 1, x + half, y);
+    uint32_t sw = buildRegion(grid, level - 1, x, y + half);
+    uint32_t se = buildRegion(grid, level - 1, x + half, y + half);
+    return join(nw, ne, sw, se);
+}
+
+void Hashlife::load(const std::vector<std::vector<int>>& grid) {
+    long long extent = static_cast<long long>(grid.size());
+    if (!grid.empty()) extent = std::max(extent, static_cast<long long>(grid[0].size()));
+    int level = 3;
+    while ((1LL << (level - 1)) < extent) ++level;
+
+    long long half = 1LL << (level - 1);
+    m_root = buildRegion(grid, level, -half, -half);
+    m_generation = 0;
+}
+
+// Level 0-3 node holding the (x, y) corner of an 8x8 macrocell leaf
+uint32_t Hashlife::buildLeafBlock(uint64_t bits, int level, int x, int y) {
+    if (level == 0) return leaf(((bits >> (y * 8 + x)) & 1) != 0);
+    int half = 1 << (level - 1);
+    return join(buildLeafBlock(bits, level - 1, x, y), buildLeafBlock(bits, level - 1, x + half, y),
+                buildLeafBlock(bits, level - 1, x, y + half), buildLeafBlock(bits, level - 1, x + half, y + half));
+}
+
+// Shifted squares already built, keyed like MacrocellOutput::regions
+struct Hashlife::ShiftedRegions {
+    std::map<std::tuple<int, uint32_t, uint32_t, uint32_t, uint32_t>, uint32_t> nodes;
+};
+
+// Node of the given level holding the cells of source from (x, y) relative to
+// its top-left; squares that line up with source's own nodes are reused as they are
+uint32_t Hashlife::shiftedRegion(uint32_t source, int level, long long x, long long y, ShiftedRegions& regions) {
+    long long size = 1LL << level;
+    long long sourceSize = 1LL << m_nodes[source].level;
+    if (x >= sourceSize || y >= sourceSize || x + size <= 0 || y + size <= 0) return emptyNode(level);
+
+    long long half = size / 2;
+    if (level > m_nodes[source].level) {
+        return join(shiftedRegion(source, level - 1, x, y, regions), shiftedRegion(source, level - 1, x + half, y, regions),
+                    shiftedRegion(source, level - 1, x, y + half, regions), shiftedRegion(source, level - 1, x + half, y + half, regions));
+    }
+
+    long long alignedX = floorToMultiple(x, size);
+    long long alignedY = floorToMultiple(y, size);
+    bool shiftedX = alignedX != x;
+    bool shiftedY = alignedY != y;
+    uint32_t nw = nodeAt(source, level, alignedX, alignedY);
+    if (!shiftedX && !shiftedY) return nw == kNone ? emptyNode(level) : nw;
+    uint32_t ne = shiftedX ? nodeAt(source, level, alignedX + size, alignedY) : kNone;
+    uint32_t sw = shiftedY ? nodeAt(source, level, alignedX, alignedY + size) : kNone;
+    uint32_t se = shiftedX && shiftedY ? nodeAt(source, level, alignedX + size, alignedY + size) : kNone;
+    if (nw == kNone && ne == kNone && sw == kNone && se == kNone) return emptyNode(level);
+
+    auto key = std::make_tuple(level, nw, ne, sw, se);
+    auto found = regions.nodes.find(key);
+    if (found != regions.nodes.end()) return found->second;
+    uint32_t node = join(shiftedRegion(source, level - 1, x, y, regions), shiftedRegion(source, level - 1, x + half, y, regions),
+                         shiftedRegion(source, level - 1, x, y + half, regions), shiftedRegion(source, level - 1, x + half, y + half, regions));
+    return regions.nodes[key] = node;
+}
+
+void Hashlife::loadMacrocell(const std::vector<MacrocellNode>& nodes, long long x, long long y) {
+    // Children always come before their parents, so one pass builds every line
+    std::vector<uint32_t> built(nodes.size(), kNone);
+    for (size_t i = 1; i < nodes.size(); ++i) {
+        const MacrocellNode& line = nodes[i];
+        if (line.leaf) {
+            built[i] = buildLeafBlock(line.bits, 3, 0, 0);
+        } else if (line.level == 1) {
+            // Multi-state cells are plain live cells here
+            built[i] = join(leaf(line.child[0] != 0), leaf(line.child[1] != 0), leaf(line.child[2] != 0), leaf(line.child[3] != 0));
+        } else {
+            uint32_t children[4];
+            for (int j = 0; j < 4; ++j) {
+                children[j] = line.child[j] != 0 ? built[line.child[j]] : emptyNode(line.level - 1);
+            }
+            built[i] = join(children[0], children[1], children[2], children[3]);
+        }
+    }
+
+    // The file's root rarely lines up with ours, so it is shifted into a
+    // root centred on the origin that is big enough to hold it
+    uint32_t source = built.back();
+    long long size = 1LL << m_nodes[source].level;
+    long long reach = std::max(std::max(-x, x + size), std::max(-y, y + size));
+    int level = 3;
+    while (level < kMaxLevel && (1LL << (level - 1)) < reach) ++level;
+
+    ShiftedRegions regions;
+    long long half = 1LL << (level - 1);
+    m_root = shiftedRegion(source, level, -half - x, -half - y, regions);
+    m_generation = 0;
+}
+
+// Write the live cells of node, whose top-left cell is universe (x, y), into
+// the grid viewport; empty and off-screen subtrees are skipped entirely
+void Hashlife::fillRegion(uint32_t node, long long x, long long y, std::vector<std::vector<int>>& grid) const {
+    const Node& n = m_nodes[node];
+    if (n.population == 0) return;
+    long long size = 1LL << n.level;
+    long long height = static_cast<long long>(grid.size());
+    long long width = grid.empty() ? 0 : static_cast<long long>(grid[0].size());
+    if (x >= width || y >= height || x + size <= 0 || y + size <= 0) return;
+    if (n.level == 0) {
+        grid[y][x] = 1;
+        return;
+    }
+    long long half = size / 2;
+    fillRegion(n.nw, x, y, grid);
+    fillRegion(n.ne, x + half, y, grid);
+    fillRegion(n.sw, x, y + half, grid);
+    fillRegion(n.se, x + half, y + half, grid);
+}
+
+void Hashlife::unpack(std::vector<std::vector<int>>& grid) const {
+    for (auto& row : grid) {
+        std::fill(row.begin(), row.end(), 0);
+    }
+    long long half = 1LL << (m_nodes[m_root].level - 1);
+    fillRegion(m_root, -half, -half, grid);
+}
+
+// Line numbers already written. A written square at a given level always lies
+// at the same offset from the aligned nodes it overlaps, since the whole tree
+// is shifted by one amount, so those nodes identify its contents.
+struct Hashlife::MacrocellOutput {
+    std::ostream& out;
+    uint32_t lines;
+    std::map<std::tuple<int, uint32_t, uint32_t, uint32_t, uint32_t>, uint32_t> regions;
+    std::map<std::tuple<int, uint32_t, uint32_t, uint32_t, uint32_t>, uint32_t> nodes;
+    std::unordered_map<uint64_t, uint32_t> leaves;
+};
+
+void Hashlife::writeMacrocell(std::ostream& out, long long centreX, long long centreY) const {
+    // Root-relative coordinates: the current root covers [0, 2 * half) on both axes
+    long long half = 1LL << (m_nodes[m_root].level - 1);
+    long long reach = half + std::max(std::max(centreX, -centreX), std::max(centreY, -centreY));
+    int level = 3;
+    while (level < kMaxLevel && (1LL << (level - 1)) < reach) ++level;
+
+    MacrocellOutput output = {out, 0, {}, {}, {}};
+    long long written = 1LL << (level - 1);
+    if (writeRegion(level, centreX - written + half, centreY - written + half, output) == 0) {
+        out << "$\n"; // an empty universe is one empty leaf
+    }
+}
+
+// Node of the given level (at most root's) whose top-left cell is at (x, y)
+// relative to root, a multiple of its size; kNone when it is empty or outside root
+uint32_t Hashlife::nodeAt(uint32_t root, int level, long long x, long long y) const {
+    long long size = 1LL << m_nodes[root].level;
+    if (x < 0 || y < 0 || x >= size || y >= size) return kNone;
+    uint32_t node = root;
+    while (m_nodes[node].level > level && m_nodes[node].population != 0) {
+        const Node& n = m_nodes[node];
+        long long half = 1LL << (n.level - 1);
+        if (y < half) {
+            node = (x < half) ? n.nw : n.ne;
+        } else {
+            node = (x < half) ? n.sw : n.se;
+            y -= half;
+        }
+        if (x >= half) x -= half;
+    }
+    return m_nodes[node].population == 0 ? kNone : node;
+}
+
+// Write the square of the given level whose top-left cell is at root-relative
+// (x, y), children before parents, and return its line number, 0 if empty
+uint32_t Hashlife::writeRegion(int level, long long x, long long y, MacrocellOutput& output) const {
+    long long size = 1LL << level;
+    long long alignedX = floorToMultiple(x, size);
+    long long alignedY = floorToMultiple(y, size);
+    bool shiftedX = alignedX != x;
+    bool shiftedY = alignedY != y;
+    uint32_t nw = nodeAt(m_root, level, alignedX, alignedY);
+    uint32_t ne = shiftedX ? nodeAt(m_root, level, alignedX + size, alignedY) : kNone;
+    uint32_t sw = shiftedY ? nodeAt(m_root, level, alignedX, alignedY + size) : kNone;
+    uint32_t se = shiftedX && shiftedY ? nodeAt(m_root, level, alignedX + size, alignedY + size) : kNone;
+    if (nw == kNone && ne == kNone && sw == kNone && se == kNone) return 0;
+
+    auto region = std::make_tuple(level, nw, ne, sw, se);
+    auto done = output.regions.find(region);
+    if (done != output.regions.end()) return done->second;
+
+    uint32_t line = 0;
+    if (level == 3) {
+        long long rootSize = 1LL << m_nodes[m_root].level;
+        uint64_t bits = 0;
+        for (int row = 0; row < 8; ++row) {
+            if (y + row < 0 || y + row >= rootSize) continue;
+            for (int column = 0; column < 8; ++column) {
+                if (x + column < 0 || x + column >= rootSize) continue;
+                if (getCell(m_root, x + column, y + row)) bits |= 1ULL << (row * 8 + column);
+            }
+        }
+        auto found = output.leaves.find(bits);
+        if (bits == 0) {
+            line = 0;
+        } else if (found != output.leaves.end()) {
+            line = found->second;
+        } else {
+            // Same leaf text as PatternIO's writer: rows up to the last live one, each up to its last live cell
+            int lastRow = 7;
+            while (((bits >> (lastRow * 8)) & 0xff) == 0) --lastRow;
+            for (int row = 0; row <= lastRow; ++row) {
+                unsigned rowBits = static_cast<unsigned>(bits >> (row * 8)) & 0xff;
+                for (int column = 0; rowBits >> column; ++column) {
+                    output.out << ((rowBits >> column) & 1 ? '*' : '.');
+                }
+                output.out << '$';
+            }
+            output.out << '\n';
+            line = output.leaves[bits] = ++output.lines;
+        }
+    } else {
+        long long half = size / 2;
+        uint32_t children[4] = {writeRegion(level - 1, x, y, output), writeRegion(level - 1, x + half, y, output),
+                                writeRegion(level - 1, x, y + half, output), writeRegion(level - 1, x + half, y + half, output)};
+        if ((children[0] | children[1] | children[2] | children[3]) != 0) {
+            auto key = std::make_tuple(level, children[0], children[1], children[2], children[3]);
+            auto found = output.nodes.find(key);
+            if (found != output.nodes.end()) {
+                line = found->second;
+            } else {
+                output.out << level << ' ' << children[0] << ' ' << children[1] << ' ' << children[2] << ' ' << children[3] << '\n';
+                line = output.nodes[key] = ++output.lines;
+            }
+        }
+    }
+    output.regions[region] = line;
+    return line;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+struct MacrocellNode;
+
+// Hashlife engine: the universe is a quadtree of canonical nodes, so identical
+// regions anywhere in space or time are stored and evolved only once. Each
+// step advances 2^k generations at once, and the universe is an unbounded
+// plane that grows as the pattern does instead of a fixed window-sized grid.
+//
+// Nodes live in one vector and refer to each other by index. A node at level n
+// covers 2^n x 2^n cells; levels 0 are the two leaf cells. Every node caches the
+// centre half of itself advanced by the current step, which is what makes
+// repeated structure nearly free. When the node count passes the limit, nodes
+// unreachable from the root are swept and their slots reused.
+class Hashlife {
+public:
+    explicit Hashlife(size_t maxNodes = 1 << 22);
+
+    // Copy cells to and from the regular vector-of-rows representation.
+    // Grid cell (x, y) is universe cell (x, y); unpack shows that same viewport.
+    void load(const std::vector<std::vector<int>>& grid);
+    void unpack(std::vector<std::vector<int>>& grid) const;
+
+    // Replace the universe with a macrocell node table (see PatternIO.h) whose
+    // root has its top-left cell at universe (x, y). Each line becomes one node,
+    // so loading costs about as much as the file, not as the population.
+    void loadMacrocell(const std::vector<MacrocellNode>& nodes, long long x, long long y);
+
+    // Write the node lines of a macrocell file (no header) holding every live
+    // cell, with universe cell (centreX, centreY) at the centre of its root,
+    // which is where readers put the centre of the window. Shared regions are
+    // written once, so the file stays as small as the quadtree.
+    void writeMacrocell(std::ostream& out, long long centreX, long long centreY) const;
+
+    void setCell(long long x, long long y, bool alive);
+    bool getCell(long long x, long long y) const;
+
+    // Generations per step are 2^exponent; changing it drops the cached results
+    void setStepExponent(int exponent);
+    int stepExponent() const { return m_stepExponent; }
+
+    // Advance 2^stepExponent() generations
+    void step();
+
+    double population() const { return m_nodes[m_root].population; }
+    double generation() const { return m_generation; }
+    size_t nodeCount() const { return m_nodes.size() - m_freeList.size(); }
+
+    // Sweep nodes unreachable from the root; called automatically from step()
+    void collectGarbage();
+
+private:
+    static constexpr uint32_t kNone = 0xffffffff;
+
+    struct MacrocellOutput;
+    struct ShiftedRegions;
+
+    struct Node {
+        uint32_t nw, ne, sw, se;
+        uint32_t result;   // centre advanced 2^min(k, level - 2) generations, or kNone
+        uint32_t next;     // hash chain
+        int level;
+        double population;
+    };
+
+    uint32_t leaf(bool alive) const { return alive ? 1 : 0; }
+    uint32_t join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+    uint32_t emptyNode(int level);
+    uint32_t centre(uint32_t node);
+    uint32_t successor(uint32_t node, int exponent);
+    uint32_t baseSuccessor(uint32_t node);
+    uint32_t setCell(uint32_t node, long long x, long long y, bool alive);
+    bool getCell(uint32_t node, long long x, long long y) const;
+    uint32_t buildRegion(const std::vector<std::vector<int>>& grid, int level, long long x, long long y);
+    uint32_t buildLeafBlock(uint64_t bits, int level, int x, int y);
+    uint32_t shiftedRegion(uint32_t source, int level, long long x, long long y, ShiftedRegions& regions);
+    void expand();
+    bool centreHoldsPattern() const;
+    void fillRegion(uint32_t node, long long x, long long y, std::vector<std::vector<int>>& grid) const;
+    uint32_t nodeAt(uint32_t root, int level, long long x, long long y) const;
+    uint32_t writeRegion(int level, long long x, long long y, MacrocellOutput& output) const;
+    void clearResults();
+    void mark(uint32_t node, std::vector<uint8_t>& marked, bool keepResults) const;
+    void rehash(size_t buckets);
+    size_t hashOf(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se) const;
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_buckets;
+    std::vector<uint32_t> m_freeList;
+    std::vector<uint32_t> m_empty; // canonical empty node per level
+    size_t m_maxNodes;
+
+    uint32_t m_root;
+    int m_stepExponent;
+    double m_generation;
+};
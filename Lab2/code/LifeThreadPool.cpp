@@ -0,0 +1,35 @@
+#include "LifeThreadPool.h"
+
+LifeThreadPool::LifeThreadPool(int width, int height, int numThreads, int tileSize, BlockedGrid::Schedule schedule,
+                               const Rule& rule)
+    : m_numThreads(numThreads), m_grid(width, height, tileSize, schedule, numThreads, rule),
+      m_start(numThreads + 1), m_done(numThreads + 1), m_stopping(false) {
+    // The calling thread joins both barriers too, hence numThreads + 1
+    for (int i = 0; i < numThreads; ++i) {
+        m_workers.emplace_back(&LifeThreadPool::workerLoop, this, i);
+    }
+}
+
+LifeThreadPool::~LifeThreadPool() {
+    m_stopping = true;
+    m_start.wait();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void LifeThreadPool::step() {
+    m_grid.beginGeneration(m_numThreads);
+    m_start.wait();
+    m_done.wait();
+    m_grid.endGeneration();
+}
+
+void LifeThreadPool::workerLoop(int index) {
+    while (true) {
+        m_start.wait();
+        if (m_stopping) return;
+        m_grid.runWorker(index);
+        m_done.wait();
+    }
+}
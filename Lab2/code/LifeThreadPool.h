@@ -0,0 +1,38 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+#include "Barrier.h"
+#include "BlockedGrid.h"
+
+// Long-lived std::thread workers for the THRD engine. The workers are created
+// once and meet at a barrier at the start and end of every generation; the
+// cells and the way blocks are shared out between workers live in BlockedGrid.
+class LifeThreadPool {
+public:
+    LifeThreadPool(int width, int height, int numThreads, int tileSize, BlockedGrid::Schedule schedule, const Rule& rule);
+    ~LifeThreadPool();
+
+    LifeThreadPool(const LifeThreadPool&) = delete;
+    LifeThreadPool& operator=(const LifeThreadPool&) = delete;
+
+    // Copy cells to and from the regular vector-of-rows representation
+    void load(const std::vector<std::vector<int>>& grid) { m_grid.load(grid); }
+    void unpack(std::vector<std::vector<int>>& grid) const { m_grid.unpack(grid); }
+
+    // Advance one generation; returns once every worker has finished its blocks
+    void step();
+
+    BlockedGrid& grid() { return m_grid; }
+
+private:
+    void workerLoop(int index);
+
+    int m_numThreads;
+    BlockedGrid m_grid;
+
+    std::vector<std::thread> m_workers;
+    Barrier m_start;
+    Barrier m_done;
+    bool m_stopping;
+};
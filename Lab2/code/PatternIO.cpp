@@ -0,0 +1,585 @@
+#include "PatternIO.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+
+// Buffered byte-at-a-time access to a stream; one read() per 64 KB
+class ByteReader {
+public:
+    explicit ByteReader(std::istream& in) : m_in(in), m_buffer(1 << 16), m_pos(0), m_end(0) {}
+
+    int peek() {
+        if (m_pos == m_end && !fill()) return EOF;
+        return static_cast<unsigned char>(m_buffer[m_pos]);
+    }
+
+    int get() {
+        int c = peek();
+        if (c != EOF) ++m_pos;
+        return c;
+    }
+
+    void skipLine() {
+        int c;
+        while ((c = get()) != EOF && c != '\n') {}
+    }
+
+    void skipSpaces() {
+        while (peek() == ' ' || peek() == '\t' || peek() == '\r') get();
+    }
+
+    // Digits at the current position; false if there are none
+    bool readNumber(long long& value) {
+        if (!std::isdigit(peek())) return false;
+        value = 0;
+        while (std::isdigit(peek())) value = value * 10 + (get() - '0');
+        return true;
+    }
+
+    // Rest of the line, without the line ending; only used for short header values
+    std::string readLine() {
+        std::string text;
+        int c;
+        while ((c = get()) != EOF && c != '\n') {
+            if (c != '\r') text += static_cast<char>(c);
+        }
+        return text;
+    }
+
+private:
+    bool fill() {
+        m_in.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+        m_pos = 0;
+        m_end = static_cast<size_t>(m_in.gcount());
+        return m_end > 0;
+    }
+
+    std::istream& m_in;
+    std::vector<char> m_buffer;
+    size_t m_pos;
+    size_t m_end;
+};
+
+std::string trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t");
+    if (first == std::string::npos) return "";
+    return text.substr(first, text.find_last_not_of(" \t") - first + 1);
+}
+
+// "x = 36, y = 9, rule = B3/S23"; the rule is last and may itself contain commas
+void parseRleHeader(const std::string& line, PatternHeader& header) {
+    size_t pos = 0;
+    while (pos < line.size()) {
+        size_t equals = line.find('=', pos);
+        if (equals == std::string::npos) break;
+        std::string key = trim(line.substr(pos, equals - pos));
+        if (key == "rule") {
+            header.rule = trim(line.substr(equals + 1));
+            break;
+        }
+        size_t comma = line.find(',', equals);
+        std::string value = trim(line.substr(equals + 1, comma == std::string::npos ? std::string::npos : comma - equals - 1));
+        if (key == "x" && !value.empty()) header.width = std::stoll(value);
+        if (key == "y" && !value.empty()) header.height = std::stoll(value);
+        if (comma == std::string::npos) break;
+        pos = comma + 1;
+    }
+}
+
+bool readRle(ByteReader& reader, PatternSink& sink, std::string& error) {
+    PatternHeader header;
+    // Comment and blank lines, including the old "#r rule" form, then the optional header line
+    int c;
+    reader.skipSpaces();
+    while ((c = reader.peek()) == '#' || c == '\n') {
+        reader.get();
+        if (c == '#' && (reader.peek() == 'r' || reader.peek() == 'R')) {
+            reader.get();
+            header.rule = trim(reader.readLine());
+        } else if (c == '#') {
+            reader.skipLine();
+        }
+        reader.skipSpaces();
+    }
+    if (reader.peek() == 'x') {
+        parseRleHeader(reader.readLine(), header);
+    }
+    if (!sink.begin(header)) return true;
+
+    long long x = 0;
+    long long y = 0;
+    long long count = 0;
+    while ((c = reader.get()) != EOF) {
+        if (std::isdigit(c)) {
+            count = count * 10 + (c - '0');
+            continue;
+        }
+        long long n = count > 0 ? count : 1;
+        if (c == 'b' || c == '.') {
+            x += n;
+        } else if (c == 'o') {
+            sink.run(x, y, n, 1);
+            x += n;
+        } else if ((c >= 'A' && c <= 'X') || (c >= 'p' && c <= 'y')) {
+            int state = 0;
+            if (c >= 'p') {
+                int letter = reader.get();
+                if (letter < 'A' || letter > 'X') {
+                    error = "bad multi-state cell in RLE";
+                    return false;
+                }
+                state = (c - 'p' + 1) * 24 + (letter - 'A' + 1);
+            } else {
+                state = c - 'A' + 1;
+            }
+            sink.run(x, y, n, state);
+            x += n;
+        } else if (c == '$') {
+            y += n;
+            x = 0;
+        } else if (c == '!') {
+            return true;
+        } else if (c == '#') {
+            reader.skipLine();
+        } else if (!std::isspace(c)) {
+            error = std::string("unexpected '") + static_cast<char>(c) + "' in RLE";
+            return false;
+        } else {
+            continue; // line breaks may fall between a count and its tag
+        }
+        count = 0;
+    }
+    return true; // a missing '!' is tolerated
+}
+
+bool readPlaintext(ByteReader& reader, PatternSink& sink, std::string& error) {
+    while (reader.peek() == '!') reader.skipLine();
+    if (!sink.begin(PatternHeader())) return true;
+
+    long long x = 0;
+    long long y = 0;
+    long long runStart = -1;
+    int c;
+    while ((c = reader.get()) != EOF) {
+        bool alive = (c == 'O' || c == '*');
+        if (!alive && runStart >= 0) {
+            sink.run(runStart, y, x - runStart, 1);
+            runStart = -1;
+        }
+        if (alive) {
+            if (runStart < 0) runStart = x;
+            ++x;
+        } else if (c == '.') {
+            ++x;
+        } else if (c == '\n') {
+            ++y;
+            x = 0;
+        } else if (c == '!' && x == 0) {
+            reader.skipLine();
+        } else if (c != '\r' && c != ' ' && c != '\t') {
+            error = std::string("unexpected '") + static_cast<char>(c) + "' in plaintext pattern";
+            return false;
+        }
+    }
+    if (runStart >= 0) sink.run(runStart, y, x - runStart, 1);
+    return true;
+}
+
+void emitMacroNode(const std::vector<MacrocellNode>& nodes, uint32_t index, long long x, long long y, PatternSink& sink) {
+    if (index == 0) return;
+    const MacrocellNode& node = nodes[index];
+    long long size = 1LL << node.level;
+    if (!sink.wantsRegion(x, y, size)) return;
+
+    if (node.level == 1) {
+        for (int i = 0; i < 4; ++i) {
+            if (node.child[i] != 0) sink.run(x + (i & 1), y + (i >> 1), 1, static_cast<int>(node.child[i]));
+        }
+    } else if (node.leaf) {
+        for (int row = 0; row < 8; ++row) {
+            unsigned bits = static_cast<unsigned>(node.bits >> (row * 8)) & 0xff;
+            int column = 0;
+            while (bits != 0) {
+                while (!(bits & 1)) {
+                    bits >>= 1;
+                    ++column;
+                }
+                int start = column;
+                while (bits & 1) {
+                    bits >>= 1;
+                    ++column;
+                }
+                sink.run(x + start, y + row, column - start, 1);
+            }
+        }
+    } else {
+        long long half = size / 2;
+        emitMacroNode(nodes, node.child[0], x, y, sink);
+        emitMacroNode(nodes, node.child[1], x + half, y, sink);
+        emitMacroNode(nodes, node.child[2], x, y + half, sink);
+        emitMacroNode(nodes, node.child[3], x + half, y + half, sink);
+    }
+}
+
+bool readMacrocellTag(ByteReader& reader, std::string& error) {
+    if (reader.get() != '[' || reader.get() != 'M' || reader.get() != '2' || reader.get() != ']') {
+        error = "macrocell files start with [M2]";
+        return false;
+    }
+    reader.skipLine();
+    return true;
+}
+
+bool isMacrocellNodeStart(int c) {
+    return c == '.' || c == '*' || c == '$' || std::isdigit(c);
+}
+
+// The comment lines before the first node only; the size would need the whole tree
+bool readMacrocellHeader(ByteReader& reader, PatternHeader& header, std::string& error) {
+    if (!readMacrocellTag(reader, error)) return false;
+    int c;
+    while ((c = reader.peek()) != EOF && !isMacrocellNodeStart(c)) {
+        reader.get();
+        if (c == '#' && reader.peek() == 'R') {
+            reader.get();
+            header.rule = trim(reader.readLine());
+        } else if (c != '\n') {
+            reader.skipLine();
+        }
+    }
+    return true;
+}
+
+bool readMacrocell(ByteReader& reader, PatternSink& sink, std::string& error) {
+    if (!readMacrocellTag(reader, error)) return false;
+
+    PatternHeader header;
+    std::vector<MacrocellNode> nodes(1); // line numbers start at 1; 0 is the empty node
+    int c;
+    while ((c = reader.peek()) != EOF) {
+        if (c == '#') {
+            reader.get();
+            if (reader.peek() == 'R') {
+                reader.get();
+                header.rule = trim(reader.readLine());
+            } else {
+                reader.skipLine();
+            }
+        } else if (c == '.' || c == '*' || c == '$') {
+            MacrocellNode leaf = {3, true, 0, {0, 0, 0, 0}};
+            int x = 0;
+            int y = 0;
+            while ((c = reader.get()) != EOF && c != '\n') {
+                if (c == '*' && x < 8 && y < 8) leaf.bits |= 1ULL << (y * 8 + x);
+                if (c == '.' || c == '*') ++x;
+                if (c == '$') {
+                    x = 0;
+                    ++y;
+                }
+            }
+            nodes.push_back(leaf);
+        } else if (std::isdigit(c)) {
+            MacrocellNode node = {0, false, 0, {0, 0, 0, 0}};
+            long long value = 0;
+            reader.readNumber(value);
+            node.level = static_cast<int>(value);
+            for (int i = 0; i < 4; ++i) {
+                reader.skipSpaces();
+                if (!reader.readNumber(value)) {
+                    error = "macrocell node line " + std::to_string(nodes.size()) + " needs four children";
+                    return false;
+                }
+                // Level 1 children are states; above that they must name earlier lines
+                if (node.level > 1 && (value >= static_cast<long long>(nodes.size()) ||
+                                       (value != 0 && nodes[value].level != node.level - 1))) {
+                    error = "macrocell node line " + std::to_string(nodes.size()) + " has a bad child";
+                    return false;
+                }
+                node.child[i] = static_cast<uint32_t>(value);
+            }
+            if (node.level < 1 || node.level > 62) {
+                error = "macrocell node line " + std::to_string(nodes.size()) + " has a bad level";
+                return false;
+            }
+            reader.skipLine();
+            nodes.push_back(node);
+        } else {
+            reader.skipLine();
+        }
+    }
+    if (nodes.size() < 2) {
+        error = "macrocell file has no nodes";
+        return false;
+    }
+
+    uint32_t root = static_cast<uint32_t>(nodes.size() - 1);
+    header.width = header.height = 1LL << nodes[root].level;
+    if (!sink.begin(header) || sink.nodes(nodes)) return true;
+    emitMacroNode(nodes, root, 0, 0, sink);
+    return true;
+}
+
+// RLE cell tags: b/o for two states, or ./A-X/pA-yO when the rule has more;
+// state -1 is the end-of-row tag
+void writeRleTag(std::ostream& out, long long count, int state, bool multiState, int& column) {
+    char tag[3] = {0, 0, 0};
+    if (state < 0) {
+        tag[0] = '$';
+    } else if (!multiState) {
+        tag[0] = state ? 'o' : 'b';
+    } else if (state == 0) {
+        tag[0] = '.';
+    } else if (state <= 24) {
+        tag[0] = static_cast<char>('A' + state - 1);
+    } else {
+        tag[0] = static_cast<char>('p' + (state - 1) / 24 - 1);
+        tag[1] = static_cast<char>('A' + (state - 1) % 24);
+    }
+    std::string text = (count > 1 ? std::to_string(count) : std::string()) + tag;
+    // Lines stay under 70 characters, as the format asks
+    if (column + text.size() > 70) {
+        out << '\n';
+        column = 0;
+    }
+    out << text;
+    column += static_cast<int>(text.size());
+}
+
+void writeRle(std::ostream& out, const std::vector<std::vector<int>>& grid, const Rule& rule) {
+    long long height = static_cast<long long>(grid.size());
+    long long width = grid.empty() ? 0 : static_cast<long long>(grid[0].size());
+    bool multiState = rule.states > 2;
+    out << "x = " << width << ", y = " << height << ", rule = " << rule.name() << '\n';
+
+    int column = 0;
+    long long pendingRows = 0;
+    for (long long y = 0; y < height; ++y) {
+        const std::vector<int>& row = grid[y];
+        long long end = width;
+        while (end > 0 && row[end - 1] == 0) --end; // trailing dead cells are implied
+        if (end == 0) {
+            ++pendingRows;
+            continue;
+        }
+        if (pendingRows > 0) writeRleTag(out, pendingRows, -1, false, column);
+        for (long long x = 0; x < end;) {
+            long long start = x;
+            while (x < end && row[x] == row[start]) ++x;
+            int state = multiState ? row[start] : (row[start] == 1);
+            writeRleTag(out, x - start, state, multiState, column);
+        }
+        pendingRows = 1;
+    }
+    out << "!\n";
+}
+
+void writePlaintext(std::ostream& out, const std::vector<std::vector<int>>& grid) {
+    out << "!Name: Lab2 snapshot\n";
+    for (const auto& row : grid) {
+        long long end = static_cast<long long>(row.size());
+        while (end > 0 && row[end - 1] != 1) --end;
+        for (long long x = 0; x < end; ++x) {
+            out << (row[x] == 1 ? 'O' : '.');
+        }
+        out << '\n';
+    }
+}
+
+// Builds the macrocell quadtree bottom-up, writing each distinct node the
+// first time it appears so children always come before their parents. The
+// grid sits in the middle of the root, which is where readers centre it again.
+class MacrocellWriter {
+public:
+    MacrocellWriter(std::ostream& out, const std::vector<std::vector<int>>& grid)
+        : m_out(out), m_grid(grid), m_lines(0) {
+        m_height = static_cast<long long>(grid.size());
+        m_width = grid.empty() ? 0 : static_cast<long long>(grid[0].size());
+    }
+
+    void write() {
+        int level = 3;
+        while ((1LL << level) < std::max(m_width, m_height)) ++level;
+        long long half = 1LL << (level - 1);
+        if (build(level, m_width / 2 - half, m_height / 2 - half) == 0) m_out << "$\n"; // an empty universe is one empty leaf
+    }
+
+private:
+    // (x, y) is the node's top-left in grid coordinates, possibly outside the grid
+    uint32_t build(int level, long long x, long long y) {
+        long long size = 1LL << level;
+        if (x >= m_width || y >= m_height || x + size <= 0 || y + size <= 0) return 0;
+        if (level == 3) return leaf(x, y);
+        long long half = 1LL << (level - 1);
+        uint32_t nw = build(level - 1, x, y);
+        uint32_t ne = build(level - 1, x + half, y);
+        uint32_t sw = build(level - 1, x, y + half);
+        uint32_t se = build(level - 1, x + half, y + half);
+        if ((nw | ne | sw | se) == 0) return 0;
+
+        auto key = std::make_tuple(level, nw, ne, sw, se);
+        auto found = m_nodes.find(key);
+        if (found != m_nodes.end()) return found->second;
+        m_out << level << ' ' << nw << ' ' << ne << ' ' << sw << ' ' << se << '\n';
+        return m_nodes[key] = ++m_lines;
+    }
+
+    uint32_t leaf(long long x, long long y) {
+        uint64_t bits = 0;
+        for (int row = 0; row < 8; ++row) {
+            if (y + row < 0 || y + row >= m_height) continue;
+            for (int column = 0; column < 8; ++column) {
+                if (x + column < 0 || x + column >= m_width) continue;
+                if (m_grid[y + row][x + column] == 1) bits |= 1ULL << (row * 8 + column);
+            }
+        }
+        if (bits == 0) return 0;
+
+        auto found = m_leaves.find(bits);
+        if (found != m_leaves.end()) return found->second;
+        int lastRow = 7;
+        while (((bits >> (lastRow * 8)) & 0xff) == 0) --lastRow;
+        for (int row = 0; row <= lastRow; ++row) {
+            unsigned rowBits = static_cast<unsigned>(bits >> (row * 8)) & 0xff;
+            for (int column = 0; rowBits >> column; ++column) {
+                m_out << ((rowBits >> column) & 1 ? '*' : '.');
+            }
+            m_out << '$';
+        }
+        m_out << '\n';
+        return m_leaves[bits] = ++m_lines;
+    }
+
+    std::ostream& m_out;
+    const std::vector<std::vector<int>>& m_grid;
+    long long m_width;
+    long long m_height;
+    uint32_t m_lines;
+    std::unordered_map<uint64_t, uint32_t> m_leaves;
+    std::map<std::tuple<int, uint32_t, uint32_t, uint32_t, uint32_t>, uint32_t> m_nodes;
+};
+
+// Keeps the header and stops the reader there
+class HeaderSink : public PatternSink {
+public:
+    explicit HeaderSink(PatternHeader& header) : m_header(header) {}
+    bool begin(const PatternHeader& header) override {
+        m_header = header;
+        return false;
+    }
+    void run(long long, long long, long long, int) override {}
+
+private:
+    PatternHeader& m_header;
+};
+
+} // namespace
+
+PatternFormat patternFormatFromPath(const std::string& path) {
+    std::string extension = path.substr(path.find_last_of('.') == std::string::npos ? path.size() : path.find_last_of('.'));
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (extension == ".cells" || extension == ".txt") return PatternFormat::Plaintext;
+    if (extension == ".mc") return PatternFormat::Macrocell;
+    return PatternFormat::Rle;
+}
+
+bool readPattern(std::istream& in, PatternFormat format, PatternSink& sink, std::string& error) {
+    ByteReader reader(in);
+    if (format == PatternFormat::Plaintext) return readPlaintext(reader, sink, error);
+    if (format == PatternFormat::Macrocell) return readMacrocell(reader, sink, error);
+    return readRle(reader, sink, error);
+}
+
+bool readPatternHeader(std::istream& in, PatternFormat format, PatternHeader& header, std::string& error) {
+    if (format == PatternFormat::Macrocell) {
+        ByteReader reader(in);
+        return readMacrocellHeader(reader, header, error);
+    }
+    HeaderSink sink(header);
+    return readPattern(in, format, sink, error);
+}
+
+void writePattern(std::ostream& out, PatternFormat format, const std::vector<std::vector<int>>& grid, const Rule& rule) {
+    if (format == PatternFormat::Plaintext) {
+        writePlaintext(out, grid);
+    } else if (format == PatternFormat::Macrocell) {
+        writeMacrocellHeader(out, rule);
+        MacrocellWriter(out, grid).write();
+    } else {
+        writeRle(out, grid, rule);
+    }
+}
+
+void writeMacrocellHeader(std::ostream& out, const Rule& rule) {
+    out << "[M2] (Lab2)\n#R " << rule.name() << '\n';
+}
+
+bool savePattern(const std::string& path, const std::vector<std::vector<int>>& grid, const Rule& rule, std::string& error) {
+    PatternFormat format = patternFormatFromPath(path);
+    return saveFile(path, [&](std::ostream& out) { writePattern(out, format, grid, rule); }, error);
+}
+
+bool saveFile(const std::string& path, const std::function<void(std::ostream&)>& write, std::string& error) {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        if (!out) {
+            error = "could not open " + temporary;
+            return false;
+        }
+        write(out);
+        if (!out.flush()) {
+            error = "could not write " + temporary;
+            return false;
+        }
+    }
+    // rename() will not replace an existing file everywhere
+    std::remove(path.c_str());
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        error = "could not rename " + temporary + " to " + path;
+        return false;
+    }
+    return true;
+}
+
+bool GridPatternSink::begin(const PatternHeader& header) {
+    for (auto& row : m_grid) {
+        std::fill(row.begin(), row.end(), 0);
+    }
+    long long height = static_cast<long long>(m_grid.size());
+    long long width = m_grid.empty() ? 0 : static_cast<long long>(m_grid[0].size());
+    // Halving each side separately keeps a written and re-read grid exactly in place
+    if (header.width > 0 && header.height > 0) {
+        m_offsetX = width / 2 - header.width / 2;
+        m_offsetY = height / 2 - header.height / 2;
+    }
+    return true;
+}
+
+void GridPatternSink::run(long long x, long long y, long long length, int state) {
+    long long height = static_cast<long long>(m_grid.size());
+    long long width = m_grid.empty() ? 0 : static_cast<long long>(m_grid[0].size());
+    y += m_offsetY;
+    if (y < 0 || y >= height) return;
+    long long start = std::max(x + m_offsetX, 0LL);
+    long long end = std::min(x + m_offsetX + length, width);
+    std::vector<int>& row = m_grid[y];
+    if (state >= m_states) state = 1;
+    for (long long i = start; i < end; ++i) {
+        row[i] = state;
+    }
+}
+
+bool GridPatternSink::wantsRegion(long long x, long long y, long long size) const {
+    long long height = static_cast<long long>(m_grid.size());
+    long long width = m_grid.empty() ? 0 : static_cast<long long>(m_grid[0].size());
+    x += m_offsetX;
+    y += m_offsetY;
+    return x < width && y < height && x + size > 0 && y + size > 0;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Rule.h"
+
+// Reading and writing Life patterns in the three common file formats:
+//   RLE        (.rle)   run-length encoded rows, with an "x = , y = , rule = " header
+//   Plaintext  (.cells) one character per cell, '.' dead and 'O' alive
+//   Macrocell  (.mc)    Golly's quadtree format, one line per distinct node
+//
+// Readers pull the file through a fixed-size buffer and hand each horizontal
+// run of cells straight to a PatternSink, so no line or row strings are built
+// however large the file is. Coordinates are relative to the pattern's top-left.
+enum class PatternFormat { Rle, Plaintext, Macrocell };
+
+// What the file says about itself before any cells; width and height are 0
+// when the format does not declare them (plaintext)
+struct PatternHeader {
+    long long width = 0;
+    long long height = 0;
+    std::string rule; // empty if the file names none
+};
+
+// One macrocell line: an 8x8 leaf (level 3, bits row by row from the
+// top-left), a multi-state 2x2 node (level 1, children are states) or an inner
+// node (children are line numbers, 0 for empty). Children are nw, ne, sw, se.
+struct MacrocellNode {
+    int level;
+    bool leaf;
+    uint64_t bits;
+    uint32_t child[4];
+};
+
+class PatternSink {
+public:
+    virtual ~PatternSink() = default;
+
+    // Called once, before the first run; return false to stop reading there
+    virtual bool begin(const PatternHeader& header) {
+        (void)header;
+        return true;
+    }
+
+    // length cells in state, starting at (x, y) and going right; state is never 0
+    virtual void run(long long x, long long y, long long length, int state) = 0;
+
+    // Macrocell readers offer the whole node table first (index 0 unused, the
+    // root last); return true to build from it directly, and no runs follow
+    virtual bool nodes(const std::vector<MacrocellNode>& table) {
+        (void)table;
+        return false;
+    }
+
+    // Lets the macrocell reader skip whole size x size squares the sink would drop anyway
+    virtual bool wantsRegion(long long x, long long y, long long size) const {
+        (void)x; (void)y; (void)size;
+        return true;
+    }
+};
+
+// Format from the file extension; Rle for anything unrecognised
+PatternFormat patternFormatFromPath(const std::string& path);
+
+// Returns false and describes the problem in error if the stream is not a valid pattern
+bool readPattern(std::istream& in, PatternFormat format, PatternSink& sink, std::string& error);
+
+// Read only as far as the header. Macrocell files only give their size with
+// the last node, so their header stops at the first node with width and height 0.
+bool readPatternHeader(std::istream& in, PatternFormat format, PatternHeader& header, std::string& error);
+
+// Write the whole grid. Plaintext and macrocell only hold two states, so dying
+// cells of Generations rules are written as dead there.
+void writePattern(std::ostream& out, PatternFormat format, const std::vector<std::vector<int>>& grid, const Rule& rule);
+
+// "[M2]" and the rule, for writers that produce their own macrocell nodes
+void writeMacrocellHeader(std::ostream& out, const Rule& rule);
+
+// Write to path through a temporary file that is renamed into place, so a
+// crash mid-write never leaves a truncated snapshot behind
+bool savePattern(const std::string& path, const std::vector<std::vector<int>>& grid, const Rule& rule, std::string& error);
+
+// The same, with write producing the whole file
+bool saveFile(const std::string& path, const std::function<void(std::ostream&)>& write, std::string& error);
+
+// Clears the grid and copies runs into it, centred when the header gives the
+// pattern's size and with its top-left in the corner otherwise. Cells outside
+// the grid are dropped, and states the rule does not have become plain live cells.
+class GridPatternSink : public PatternSink {
+public:
+    GridPatternSink(std::vector<std::vector<int>>& grid, int states) : m_grid(grid), m_states(states) {}
+
+    bool begin(const PatternHeader& header) override;
+    void run(long long x, long long y, long long length, int state) override;
+    bool wantsRegion(long long x, long long y, long long size) const override;
+
+    long long offsetX() const { return m_offsetX; }
+    long long offsetY() const { return m_offsetY; }
+
+private:
+    std::vector<std::vector<int>>& m_grid;
+    int m_states;
+    long long m_offsetX = 0;
+    long long m_offsetY = 0;
+};
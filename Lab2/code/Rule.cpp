@@ -0,0 +1,192 @@
+#include "Rule.h"
+
+#include <cctype>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+const int kMaxStates = 256; // states are stored in one byte
+const int kMaxRange = 500;
+
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, separator)) {
+        parts.push_back(part);
+    }
+    // getline drops a trailing empty field, which "B3/S" needs
+    if (!text.empty() && text.back() == separator) parts.push_back("");
+    return parts;
+}
+
+// Neighbour counts 0-8 written as digits, e.g. "23"
+bool parseCounts(const std::string& digits, uint32_t& mask, std::string& error) {
+    mask = 0;
+    for (char c : digits) {
+        if (c < '0' || c > '8') {
+            error = std::string("neighbour count '") + c + "' is not a digit from 0 to 8";
+            return false;
+        }
+        mask |= 1u << (c - '0');
+    }
+    return true;
+}
+
+std::string countDigits(uint32_t mask) {
+    std::string digits;
+    for (int n = 0; n <= 8; ++n) {
+        if (mask & (1u << n)) digits += static_cast<char>('0' + n);
+    }
+    return digits;
+}
+
+bool parseNumber(const std::string& text, int& value) {
+    if (text.empty() || text.size() > 9) return false;
+    for (char c : text) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) return false;
+    }
+    value = std::stoi(text);
+    return true;
+}
+
+// "34..58", or a single count
+bool parseInterval(const std::string& text, int& low, int& high) {
+    size_t dots = text.find("..");
+    if (dots == std::string::npos) {
+        if (!parseNumber(text, low)) return false;
+        high = low;
+        return true;
+    }
+    return parseNumber(text.substr(0, dots), low) && parseNumber(text.substr(dots + 2), high) && low <= high;
+}
+
+// Golly's Larger than Life notation, e.g. "R5,C0,M1,S34..58,B34..45,NM"
+bool parseLargerThanLife(const std::string& text, Rule& rule, std::string& error) {
+    Rule parsed;
+    parsed.family = Rule::Family::LargerThanLife;
+    bool haveBirth = false;
+    bool haveSurvival = false;
+    for (const std::string& field : split(text, ',')) {
+        if (field.empty()) continue;
+        char key = static_cast<char>(std::toupper(static_cast<unsigned char>(field[0])));
+        std::string value = field.substr(1);
+        int number;
+        if (key == 'R') {
+            if (!parseNumber(value, number) || number < 1 || number > kMaxRange) {
+                error = "range must be from 1 to " + std::to_string(kMaxRange);
+                return false;
+            }
+            parsed.range = number;
+        } else if (key == 'C') {
+            if (!parseNumber(value, number) || number > kMaxStates) {
+                error = "state count must be at most " + std::to_string(kMaxStates);
+                return false;
+            }
+            parsed.states = number < 2 ? 2 : number;
+        } else if (key == 'M') {
+            if (value != "0" && value != "1") {
+                error = "M must be 0 or 1";
+                return false;
+            }
+            parsed.countCentre = (value == "1");
+        } else if (key == 'S') {
+            haveSurvival = parseInterval(value, parsed.survivalMin, parsed.survivalMax);
+            if (!haveSurvival) {
+                error = "bad survival interval '" + value + "'";
+                return false;
+            }
+        } else if (key == 'B') {
+            haveBirth = parseInterval(value, parsed.birthMin, parsed.birthMax);
+            if (!haveBirth) {
+                error = "bad birth interval '" + value + "'";
+                return false;
+            }
+        } else if (key == 'N') {
+            if (value != "M" && value != "m") {
+                error = "only the Moore neighbourhood (NM) is supported";
+                return false;
+            }
+        } else {
+            error = "unknown field '" + field + "'";
+            return false;
+        }
+    }
+    if (!haveBirth || !haveSurvival) {
+        error = "Larger than Life rules need both B and S intervals";
+        return false;
+    }
+    rule = parsed;
+    return true;
+}
+
+} // namespace
+
+std::string Rule::name() const {
+    if (family == Family::LargerThanLife) {
+        std::stringstream stream;
+        stream << "R" << range << ",C" << (states == 2 ? 0 : states) << ",M" << (countCentre ? 1 : 0)
+               << ",S" << survivalMin << ".." << survivalMax << ",B" << birthMin << ".." << birthMax << ",NM";
+        return stream.str();
+    }
+    std::string text = "B" + countDigits(birth) + "/S" + countDigits(survival);
+    if (family == Family::Generations) text += "/C" + std::to_string(states);
+    return text;
+}
+
+bool Rule::parse(const std::string& text, Rule& rule, std::string& error) {
+    if (text.find(',') != std::string::npos || (!text.empty() && (text[0] == 'R' || text[0] == 'r'))) {
+        return parseLargerThanLife(text, rule, error);
+    }
+
+    std::vector<std::string> fields = split(text, '/');
+    if (fields.size() < 2 || fields.size() > 3) {
+        error = "expected B/S, S/B, B/S/C or S/B/C";
+        return false;
+    }
+
+    // Either every field is tagged with B, S or C, or they are untagged S/B[/C]
+    std::string birthDigits;
+    std::string survivalDigits;
+    std::string stateText;
+    bool tagged = !fields[0].empty() && std::isalpha(static_cast<unsigned char>(fields[0][0]));
+    for (size_t i = 0; i < fields.size(); ++i) {
+        const std::string& field = fields[i];
+        if (tagged) {
+            char key = field.empty() ? '\0' : static_cast<char>(std::toupper(static_cast<unsigned char>(field[0])));
+            if (key == 'B') {
+                birthDigits = field.substr(1);
+            } else if (key == 'S') {
+                survivalDigits = field.substr(1);
+            } else if (key == 'C' || key == 'G') {
+                stateText = field.substr(1);
+            } else {
+                error = "field '" + field + "' does not start with B, S or C";
+                return false;
+            }
+        } else if (i == 0) {
+            survivalDigits = field;
+        } else if (i == 1) {
+            birthDigits = field;
+        } else {
+            stateText = field;
+        }
+    }
+
+    Rule parsed;
+    if (!parseCounts(birthDigits, parsed.birth, error) || !parseCounts(survivalDigits, parsed.survival, error)) {
+        return false;
+    }
+    if (!stateText.empty()) {
+        int states;
+        if (!parseNumber(stateText, states) || states < 2 || states > kMaxStates) {
+            error = "state count must be from 2 to " + std::to_string(kMaxStates);
+            return false;
+        }
+        parsed.states = states;
+        if (states > 2) parsed.family = Family::Generations;
+    }
+    rule = parsed;
+    return true;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Cellular automaton rule on the square grid. State 0 is dead and 1 is alive;
+// multi-state rules add dying states 2..states-1, which no longer count as
+// live neighbours and age by one state per generation until they die.
+//   Life-like:        "B3/S23", or the older S/B form "23/3"
+//   Generations:      "B2/S/C3", or S/B/C as in "/2/3"
+//   Larger than Life: "R5,C0,M1,S34..58,B34..45,NM", counting live cells in
+//                     the (2R+1)x(2R+1) Moore box, with the centre if M1
+struct Rule {
+    enum class Family { LifeLike, Generations, LargerThanLife };
+
+    Family family = Family::LifeLike;
+    uint32_t birth = 1u << 3;                 // Life-like/Generations: bit n set to be born with n neighbours
+    uint32_t survival = (1u << 2) | (1u << 3); // and to survive with n neighbours
+    int states = 2;
+    int range = 1;
+    bool countCentre = false;                 // Larger than Life only, from here down
+    int birthMin = 0;
+    int birthMax = 0;
+    int survivalMin = 0;
+    int survivalMax = 0;
+
+    bool isConway() const {
+        return family == Family::LifeLike && birth == (1u << 3) && survival == ((1u << 2) | (1u << 3));
+    }
+
+    // Canonical rulestring, e.g. "B3/S23"
+    std::string name() const;
+
+    // Returns false and describes the problem in error when text is not a rulestring
+    static bool parse(const std::string& text, Rule& rule, std::string& error);
+};
+
+// The kernels below turn a cell state and its live neighbour count into the
+// next state without branching. Each rule family gets its own kernel type, and
+// withKernel() picks one per call, so an engine templated on the kernel tests
+// the rule once per block or grid instead of once per cell.
+
+// Life-like rule known at compile time. Birth and survival masks sit side by
+// side in one constant, so the next state is a single shift by count + 9*state.
+template <uint32_t Birth, uint32_t Survival>
+struct LifeLikeKernel {
+    static int live(uint8_t state) { return state; }
+    int range() const { return 1; }
+    bool countCentre() const { return false; }
+    uint8_t next(uint8_t state, int count) const {
+        return static_cast<uint8_t>(((Birth | (Survival << 9)) >> (count + 9 * state)) & 1);
+    }
+};
+
+// Any other Life-like rule, with the same table held in a register
+struct LifeTableKernel {
+    explicit LifeTableKernel(const Rule& rule) : m_table(rule.birth | (rule.survival << 9)) {}
+    static int live(uint8_t state) { return state; }
+    int range() const { return 1; }
+    bool countCentre() const { return false; }
+    uint8_t next(uint8_t state, int count) const {
+        return static_cast<uint8_t>((m_table >> (count + 9 * state)) & 1);
+    }
+
+    uint32_t m_table;
+};
+
+// Generations: live cells that fail the survival test start dying, and dying
+// cells advance one state until they wrap round to dead
+struct GenerationsKernel {
+    explicit GenerationsKernel(const Rule& rule)
+        : m_birth(rule.birth), m_survival(rule.survival), m_states(rule.states) {}
+    static int live(uint8_t state) { return state == 1; }
+    int range() const { return 1; }
+    bool countCentre() const { return false; }
+    uint8_t next(uint8_t state, int count) const {
+        uint32_t keep = ((m_birth >> count) & (state == 0)) | ((m_survival >> count) & (state == 1));
+        int aged = (state + 1) * (state != 0) * (state + 1 < m_states);
+        return static_cast<uint8_t>(keep + aged * (1 - keep));
+    }
+
+    uint32_t m_birth;
+    uint32_t m_survival;
+    int m_states;
+};
+
+// Larger than Life: birth and survival are count intervals, tested with one
+// unsigned comparison each; ageing works as in Generations
+struct LargerThanLifeKernel {
+    explicit LargerThanLifeKernel(const Rule& rule)
+        : m_range(rule.range), m_countCentre(rule.countCentre), m_states(rule.states),
+          m_birthMin(rule.birthMin), m_birthSpan(rule.birthMax - rule.birthMin),
+          m_survivalMin(rule.survivalMin), m_survivalSpan(rule.survivalMax - rule.survivalMin) {}
+    static int live(uint8_t state) { return state == 1; }
+    int range() const { return m_range; }
+    bool countCentre() const { return m_countCentre; }
+    uint8_t next(uint8_t state, int count) const {
+        uint32_t born = static_cast<uint32_t>(count - m_birthMin) <= m_birthSpan;
+        uint32_t survives = static_cast<uint32_t>(count - m_survivalMin) <= m_survivalSpan;
+        uint32_t keep = (born & (state == 0)) | (survives & (state == 1));
+        int aged = (state + 1) * (state != 0) * (state + 1 < m_states);
+        return static_cast<uint8_t>(keep + aged * (1 - keep));
+    }
+
+    int m_range;
+    bool m_countCentre;
+    int m_states;
+    int m_birthMin;
+    uint32_t m_birthSpan;
+    int m_survivalMin;
+    uint32_t m_survivalSpan;
+};
+
+// Masks of a few common Life-like rules that get their own compiled kernel
+const uint32_t kConwayBirth = 1u << 3;
+const uint32_t kConwaySurvival = (1u << 2) | (1u << 3);
+const uint32_t kHighLifeBirth = (1u << 3) | (1u << 6);
+const uint32_t kSeedsBirth = 1u << 2;
+const uint32_t kDayNightBirth = (1u << 3) | (1u << 6) | (1u << 7) | (1u << 8);
+const uint32_t kDayNightSurvival = (1u << 3) | (1u << 4) | (1u << 6) | (1u << 7) | (1u << 8);
+
+// Call visit(kernel) with the most specialised kernel for rule
+template <typename Visitor>
+void withKernel(const Rule& rule, Visitor&& visit) {
+    if (rule.family == Rule::Family::Generations) {
+        visit(GenerationsKernel(rule));
+    } else if (rule.family == Rule::Family::LargerThanLife) {
+        visit(LargerThanLifeKernel(rule));
+    } else if (rule.birth == kConwayBirth && rule.survival == kConwaySurvival) {
+        visit(LifeLikeKernel<kConwayBirth, kConwaySurvival>());
+    } else if (rule.birth == kHighLifeBirth && rule.survival == kConwaySurvival) {
+        visit(LifeLikeKernel<kHighLifeBirth, kConwaySurvival>());
+    } else if (rule.birth == kSeedsBirth && rule.survival == 0) {
+        visit(LifeLikeKernel<kSeedsBirth, 0>());
+    } else if (rule.birth == kDayNightBirth && rule.survival == kDayNightSurvival) {
+        visit(LifeLikeKernel<kDayNightBirth, kDayNightSurvival>());
+    } else {
+        visit(LifeTableKernel(rule));
+    }
+}
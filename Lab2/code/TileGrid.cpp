@@ -0,0 +1,95 @@
+#include "TileGrid.h"
+
+#include <algorithm>
+
+TileGrid::TileGrid(int width, int height, int tileSize)
+    : m_width(width), m_height(height), m_stride(width + 2),
+      m_tileSize(std::max(tileSize, 1)) {
+    m_tilesX = (width + m_tileSize - 1) / m_tileSize;
+    m_tilesY = (height + m_tileSize - 1) / m_tileSize;
+    m_front.assign(static_cast<size_t>(width + 2) * (height + 2), 0);
+    m_back.assign(m_front.size(), 0);
+    m_tileActive.assign(static_cast<size_t>(m_tilesX) * m_tilesY, 0);
+    activateAll();
+}
+
+void TileGrid::load(const std::vector<std::vector<int>>& grid) {
+    for (int y = 0; y < m_height; ++y) {
+        for (int x = 0; x < m_width; ++x) {
+            m_front[(y + 1) * m_stride + x + 1] = grid[y][x] ? 1 : 0;
+        }
+    }
+    // Both buffers must agree before the first step, see the class comment
+    m_back = m_front;
+    activateAll();
+}
+
+void TileGrid::unpack(std::vector<std::vector<int>>& grid) const {
+    for (int y = 0; y < m_height; ++y) {
+        for (int x = 0; x < m_width; ++x) {
+            grid[y][x] = m_front[(y + 1) * m_stride + x + 1];
+        }
+    }
+}
+
+void TileGrid::activateAll() {
+    m_activeList.clear();
+    for (int tile = 0; tile < tileCount(); ++tile) {
+        m_tileActive[tile] = 1;
+        m_activeList.push_back(tile);
+    }
+}
+
+void TileGrid::step() {
+    m_changedList.clear();
+    for (int tile : m_activeList) {
+        if (processTile(tile)) m_changedList.push_back(tile);
+    }
+    m_front.swap(m_back);
+
+    // Next generation: every changed tile and its neighbours
+    for (int tile : m_activeList) {
+        m_tileActive[tile] = 0;
+    }
+    m_activeList.clear();
+    for (int tile : m_changedList) {
+        int tx = tile % m_tilesX;
+        int ty = tile / m_tilesX;
+        for (int ny = std::max(ty - 1, 0); ny <= std::min(ty + 1, m_tilesY - 1); ++ny) {
+            for (int nx = std::max(tx - 1, 0); nx <= std::min(tx + 1, m_tilesX - 1); ++nx) {
+                int neighbour = ny * m_tilesX + nx;
+                if (!m_tileActive[neighbour]) {
+                    m_tileActive[neighbour] = 1;
+                    m_activeList.push_back(neighbour);
+                }
+            }
+        }
+    }
+}
+
+bool TileGrid::processTile(int tile) {
+    int x0 = (tile % m_tilesX) * m_tileSize + 1;
+    int y0 = (tile / m_tilesX) * m_tileSize + 1;
+    int x1 = std::min(x0 + m_tileSize, m_width + 1);
+    int y1 = std::min(y0 + m_tileSize, m_height + 1);
+
+    const uint8_t* src = m_front.data();
+    uint8_t* dst = m_back.data();
+    uint8_t changed = 0;
+    for (int y = y0; y < y1; ++y) {
+        const uint8_t* above = src + (y - 1) * m_stride;
+        const uint8_t* row = src + y * m_stride;
+        const uint8_t* below = src + (y + 1) * m_stride;
+        uint8_t* out = dst + y * m_stride;
+        for (int x = x0; x < x1; ++x) {
+            int liveNeighbors = above[x - 1] + above[x] + above[x + 1]
+                              + row[x - 1] + row[x + 1]
+                              + below[x - 1] + below[x] + below[x + 1];
+            // Alive with 3 neighbours, or already alive with 2
+            uint8_t cell = (liveNeighbors == 3) | (row[x] & (liveNeighbors == 2));
+            changed |= cell ^ row[x];
+            out[x] = cell;
+        }
+    }
+    return changed != 0;
+}
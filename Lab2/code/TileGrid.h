@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Sparse Game of Life engine. The grid is split into square tiles and only
+// tiles that changed last generation, plus their eight neighbours, are
+// recomputed; everything else is known to be unchanged. Settled boards with a
+// few oscillators therefore cost next to nothing per generation.
+//
+// Cells live in two flat buffers with a dead one-cell border. A tile skipped
+// this generation was also unchanged last generation, so the back buffer
+// already holds its current contents and the buffers can simply be swapped.
+class TileGrid {
+public:
+    TileGrid(int width, int height, int tileSize = 32);
+
+    // Copy cells to and from the regular vector-of-rows representation
+    void load(const std::vector<std::vector<int>>& grid);
+    void unpack(std::vector<std::vector<int>>& grid) const;
+
+    // Advance one generation, recomputing only the active tiles
+    void step();
+
+    // Tiles that will be recomputed by the next step
+    int activeTiles() const { return static_cast<int>(m_activeList.size()); }
+    int tileCount() const { return m_tilesX * m_tilesY; }
+
+private:
+    // Compute one tile into the back buffer; returns true if any cell changed
+    bool processTile(int tile);
+    void activateAll();
+
+    int m_width;
+    int m_height;
+    int m_stride;
+    int m_tileSize;
+    int m_tilesX;
+    int m_tilesY;
+    std::vector<uint8_t> m_front;
+    std::vector<uint8_t> m_back;
+
+    std::vector<uint8_t> m_tileActive; // one flag per tile, set while it is in m_activeList
+    std::vector<int> m_activeList;
+    std::vector<int> m_changedList;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+
+// Lock-free single-producer/single-consumer triple buffer. The producer fills
+// its back slot and publishes it by swapping it with the middle slot; the
+// consumer swaps the middle slot into its front slot whenever a fresh one is
+// waiting. Neither side ever blocks the other, and the consumer always sees
+// the most recently completed value.
+template <typename T>
+class TripleBuffer {
+public:
+    explicit TripleBuffer(const T& initial)
+        : m_slots{initial, initial, initial}, m_middle(1), m_back(0), m_front(2) {}
+
+    // Producer side
+    T& writeBuffer() { return m_slots[m_back]; }
+
+    void publish() {
+        m_back = m_middle.exchange(m_back | kFresh, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // True once the consumer has taken the last published value, so the
+    // producer can skip filling slots nobody would ever look at
+    bool consumed() const {
+        return (m_middle.load(std::memory_order_acquire) & kFresh) == 0;
+    }
+
+    // Consumer side: returns true if a newer value was swapped in
+    bool update() {
+        if ((m_middle.load(std::memory_order_relaxed) & kFresh) == 0) return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+
+    const T& readBuffer() const { return m_slots[m_front]; }
+
+private:
+    static constexpr int kIndexMask = 3;
+    static constexpr int kFresh = 4;
+
+    T m_slots[3];
+    std::atomic<int> m_middle; // slot index plus kFresh when unread
+    int m_back;                // owned by the producer
+    int m_front;               // owned by the consumer
+};
@@ -4,9 +4,26 @@
 #include <thread>
 #include <string>
 #include <random>
-#include "/opt/homebrew/opt/libomp/include/omp.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include <chrono>
 #include <mutex>
+#include <memory>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include "BitGrid.h"
+#include "LifeThreadPool.h"
+#include "TileGrid.h"
+#include "Hashlife.h"
+#include "GridRenderer.h"
+#include "TripleBuffer.h"
+#include "Benchmark.h"
+#include "Rule.h"
+#include "PatternIO.h"
+#include "Profiler.h"
+#include "ProfilerOverlay.h"
 
 using namespace std;
 
@@ -17,8 +34,35 @@ int window_width = 800;
 int window_height = 600;
 int grid_width;
 int grid_height;
+int tile_size = 32;
+std::string schedule_name = "static";
+Rule rule; // B3/S23 unless -rule or the loaded pattern says otherwise
+bool rule_given = false;
+int hash_step_exponent = 0;
+long long hash_max_nodes = 1 << 22;
 std::string processing_type = "THRD";
+std::string render_mode = "texture";
 std::mutex grid_mutex;
+unsigned int seed = std::random_device{}();
+
+// Run the simulation on its own thread, independent of the display rate
+bool pipelined = false;
+
+// Start from a pattern file instead of random cells, and write snapshots every so many generations
+std::string pattern_path;
+std::string snapshot_path;
+long long snapshot_every = 0;
+
+// Headless benchmark options; empty sweep lists fall back to -t, -n and the window-derived grid size
+bool headless = false;
+int bench_generations = 100;
+std::string bench_engines;
+std::string bench_sizes;
+std::string bench_threads;
+std::string bench_schedules;
+std::string bench_rules;
+std::string bench_format = "csv";
+std::string bench_output;
 
 // Parse command line arguments
 void parseCommandLine(int argc, char* argv[]) {
@@ -36,18 +80,87 @@ void parseCommandLine(int argc, char* argv[]) {
             window_height = std::stoi(argv[++i]);
         } else if (arg == "-t" && i + 1 < argc) {
             processing_type = argv[++i];
-            if (processing_type != "SEQ" && processing_type != "THRD" && processing_type != "OMP") {
+            if (processing_type != "SEQ" && processing_type != "THRD" && processing_type != "OMP" && processing_type != "SIMD" && processing_type != "TILE" && processing_type != "HASH") {
                 processing_type = "THRD";
             }
+        } else if (arg == "-k" && i + 1 < argc) {
+            hash_step_exponent = std::stoi(argv[++i]);
+            if (hash_step_exponent < 0) hash_step_exponent = 0;
+        } else if (arg == "-hashnodes" && i + 1 < argc) {
+            hash_max_nodes = std::stoll(argv[++i]);
+        } else if (arg == "-tile" && i + 1 < argc) {
+            tile_size = std::stoi(argv[++i]);
+            if (tile_size < 1) tile_size = 32;
+        } else if (arg == "-schedule" && i + 1 < argc) {
+            schedule_name = argv[++i];
+        } else if (arg == "-rule" && i + 1 < argc) {
+            std::string error;
+            if (Rule::parse(argv[++i], rule, error)) {
+                rule_given = true;
+            } else {
+                std::cerr << "Ignoring rule " << argv[i] << ": " << error << std::endl;
+            }
+        } else if (arg == "-r" && i + 1 < argc) {
+            render_mode = argv[++i];
+        } else if (arg == "-s" && i + 1 < argc) {
+            seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+        } else if (arg == "-p") {
+            pipelined = true;
+        } else if (arg == "-load" && i + 1 < argc) {
+            pattern_path = argv[++i];
+        } else if (arg == "-save" && i + 1 < argc) {
+            snapshot_path = argv[++i];
+        } else if (arg == "-every" && i + 1 < argc) {
+            snapshot_every = std::stoll(argv[++i]);
+            if (snapshot_every < 0) snapshot_every = 0;
+        } else if (arg == "-b") {
+            headless = true;
+        } else if (arg == "-g" && i + 1 < argc) {
+            bench_generations = std::stoi(argv[++i]);
+            if (bench_generations < 1) bench_generations = 100;
+        } else if (arg == "-engines" && i + 1 < argc) {
+            bench_engines = argv[++i];
+        } else if (arg == "-sizes" && i + 1 < argc) {
+            bench_sizes = argv[++i];
+        } else if (arg == "-threads" && i + 1 < argc) {
+            bench_threads = argv[++i];
+        } else if (arg == "-schedules" && i + 1 < argc) {
+            bench_schedules = argv[++i];
+        } else if (arg == "-rules" && i + 1 < argc) {
+            bench_rules = argv[++i];
+        } else if (arg == "-f" && i + 1 < argc) {
+            bench_format = argv[++i];
+            if (bench_format != "csv" && bench_format != "json") bench_format = "csv";
+        } else if (arg == "-o" && i + 1 < argc) {
+            bench_output = argv[++i];
         }
     }
-    if (processing_type == "SEQ") num_threads = 1;
+    if (processing_type == "SEQ" || processing_type == "SIMD" || processing_type == "TILE" || processing_type == "HASH") num_threads = 1;
+}
+
+// Take the rule from the pattern file's header unless -rule was given
+void adoptPatternRule() {
+    std::ifstream file(pattern_path, std::ios::binary);
+    PatternHeader header;
+    std::string error;
+    if (!file || !readPatternHeader(file, patternFormatFromPath(pattern_path), header, error) || header.rule.empty()) return;
+    if (!Rule::parse(header.rule, rule, error)) {
+        std::cerr << "Ignoring rule " << header.rule << " from " << pattern_path << ": " << error << std::endl;
+    }
+}
+
+// The bit-packed, tiled and Hashlife engines only know B3/S23
+void checkEngineSupportsRule() {
+    if (!rule.isConway() && (processing_type == "SIMD" || processing_type == "TILE" || processing_type == "HASH")) {
+        std::cerr << processing_type << " only runs B3/S23, using THRD for " << rule.name() << std::endl;
+        processing_type = "THRD";
+        if (num_threads < 2) num_threads = 8;
+    }
 }
 
-// Initialize the grid with random alive or dead cells
-void initializeGrid(std::vector<std::vector<int>>& grid, int width, int height) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+// Initialize the grid with random alive or dead cells; the same seed always gives the same grid
+void initializeGrid(std::vector<std::vector<int>>& grid, int width, int height, unsigned int seed) {
+    std::mt19937 gen(seed);
     std::uniform_int_distribution<> dis(0, 1);
     for (int y = 0; y < height; ++y) {
         for (int x = 0; x < width; ++x) {
@@ -56,155 +169,560 @@ void initializeGrid(std::vector<std::vector<int>>& grid, int width, int height)
     }
 }
 
-// Function to count live neighbors
-int countLiveNeighbors(const std::vector<std::vector<int>>& grid, int x, int y) {
+// Function to count live neighbors within range cells of (x, y); dying cells of multi-state rules do not count
+int countLiveNeighbors(const std::vector<std::vector<int>>& grid, int x, int y, int range, bool countCentre) {
     int count = 0;
-    for (int dx = -1; dx <= 1; ++dx) {
-        for (int dy = -1; dy <= 1; ++dy) {
-            if (dx == 0 && dy == 0) continue; // Skip the cell itself
+    for (int dx = -range; dx <= range; ++dx) {
+        for (int dy = -range; dy <= range; ++dy) {
+            if (dx == 0 && dy == 0 && !countCentre) continue; // Skip the cell itself
             int nx = x + dx, ny = y + dy;
             // Check boundaries
             if (nx >= 0 && nx < grid_width && ny >= 0 && ny < grid_height) {
-                count += grid[ny][nx]; // Increment count if neighbor is alive
+                count += (grid[ny][nx] == 1); // Increment count if neighbor is alive
             }
         }
     }
     return count;
 }
 
-// Function to update the grid based on the Game of Life rules
-std::vector<std::vector<int>> updateGrid(const std::vector<std::vector<int>>& grid) {
+// Function to update the grid; the kernel holds the rule, so the loop is compiled once per rule family
+template <typename Kernel>
+std::vector<std::vector<int>> updateGrid(const std::vector<std::vector<int>>& grid, const Kernel& kernel) {
     std::vector<std::vector<int>> newGrid(grid_height, std::vector<int>(grid_width, 0));
 
     for (int y = 0; y < grid_height; ++y) {
         for (int x = 0; x < grid_width; ++x) {
-            int liveNeighbors = countLiveNeighbors(grid, x, y);
-            if (grid[y][x] == 1) {
-                // Cell is alive
-                newGrid[y][x] = (liveNeighbors == 2 || liveNeighbors == 3) ? 1 : 0; // Stay alive
-            } else {
-                // Cell is dead
-                newGrid[y][x] = (liveNeighbors == 3) ? 1 : 0; // Becomes alive
-            }
+            int liveNeighbors = countLiveNeighbors(grid, x, y, kernel.range(), kernel.countCentre());
+            newGrid[y][x] = kernel.next(static_cast<uint8_t>(grid[y][x]), liveNeighbors);
         }
     }
     return newGrid;
 }
 
 // Sequential processing
-void sequentialProcessing(std::vector<std::vector<int>>& grid) {
-    grid = updateGrid(grid);
+void sequentialProcessing(std::vector<std::vector<int>>& grid, const Rule& rule) {
+    withKernel(rule, [&](const auto& kernel) { grid = updateGrid(grid, kernel); });
 }
 
-// Multithreaded processing using std::thread
-void multithreadedProcessing(std::vector<std::vector<int>>& grid, int num_threads) {
-    std::vector<std::thread> threads;
-    std::vector<std::vector<int>> newGrid(grid_height, std::vector<int>(grid_width, 0));
+// OpenMP processing over cache-sized blocks; each OpenMP thread runs one
+// BlockedGrid worker so OMP and THRD share the same schedules
+void ompProcessing(BlockedGrid& blocks, int num_threads) {
+#ifdef _OPENMP
+    #pragma omp parallel num_threads(num_threads)
+    {
+        // OpenMP may start fewer threads than asked for, so split the bands
+        // between the ones that did run; the end of single waits for all of them
+        #pragma omp single
+        blocks.beginGeneration(omp_get_num_threads());
+
+        blocks.runWorker(omp_get_thread_num());
+    }
+#else
+    // Without OpenMP the first worker claims (or steals) every block
+    blocks.beginGeneration(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        blocks.runWorker(i);
+    }
+#endif
+    blocks.endGeneration();
+}
+
+// Storage for the engines that keep their own copy of the grid between generations
+struct Engine {
+    std::string type;
+    int threads = 1;
+    BlockedGrid::Schedule schedule = BlockedGrid::Schedule::Static;
+    Rule rule;
+    std::unique_ptr<BitGrid> bitGrid;              // SIMD: one bit per cell
+    std::unique_ptr<LifeThreadPool> threadPool;    // THRD: persistent workers over cache-blocked double buffers
+    std::unique_ptr<BlockedGrid> blockedGrid;      // OMP: the same blocked buffers, driven by OpenMP threads
+    std::unique_ptr<TileGrid> tileGrid;            // TILE: only recomputes tiles near last generation's changes
+    std::unique_ptr<Hashlife> hashlife;            // HASH: unbounded memoized quadtree, 2^k generations per step
+};
+
+// Create whatever the selected engine needs and load the grid into it
+void createEngine(Engine& engine, const std::vector<std::vector<int>>& grid) {
+    if (engine.type == "SIMD") {
+        engine.bitGrid = std::make_unique<BitGrid>(grid_width, grid_height);
+        engine.bitGrid->pack(grid);
+    } else if (engine.type == "THRD") {
+        engine.threadPool = std::make_unique<LifeThreadPool>(grid_width, grid_height, engine.threads, tile_size, engine.schedule, engine.rule);
+        engine.threadPool->load(grid);
+    } else if (engine.type == "OMP") {
+        engine.blockedGrid = std::make_unique<BlockedGrid>(grid_width, grid_height, tile_size, engine.schedule, engine.threads, engine.rule);
+        engine.blockedGrid->load(grid);
+    } else if (engine.type == "TILE") {
+        engine.tileGrid = std::make_unique<TileGrid>(grid_width, grid_height, tile_size);
+        engine.tileGrid->load(grid);
+    } else if (engine.type == "HASH") {
+        engine.hashlife = std::make_unique<Hashlife>(static_cast<size_t>(hash_max_nodes));
+        engine.hashlife->setStepExponent(hash_step_exponent);
+        engine.hashlife->load(grid);
+    }
+}
+
+// Advance the selected engine by one generation
+void stepEngine(Engine& engine, std::vector<std::vector<int>>& grid) {
+    if (engine.type == "SEQ") {
+        sequentialProcessing(grid, engine.rule);
+    } else if (engine.type == "THRD") {
+        engine.threadPool->step();
+    } else if (engine.type == "OMP") {
+        ompProcessing(*engine.blockedGrid, engine.threads);
+    } else if (engine.type == "SIMD") {
+        engine.bitGrid->step();
+    } else if (engine.type == "TILE") {
+        engine.tileGrid->step();
+    } else if (engine.type == "HASH") {
+        engine.hashlife->step();
+    }
+}
 
-    int rows_per_thread = grid_height / num_threads;
+// Per-thread timings of the blocked engines, or nullptr for the others
+BlockedGrid* blockedGridOf(Engine& engine) {
+    if (engine.threadPool) return &engine.threadPool->grid();
+    return engine.blockedGrid.get();
+}
+
+// True when the engine keeps the cells itself rather than in the grid it was given
+bool ownsCells(const Engine& engine) {
+    return engine.bitGrid || engine.threadPool || engine.blockedGrid || engine.tileGrid || engine.hashlife;
+}
 
+// Finish a timing line with the block schedule and each thread's busy time, then start counting afresh
+void printThreadStats(BlockedGrid& blocks, int num_threads) {
+    std::cout << ", " << BlockedGrid::scheduleName(blocks.schedule()) << " schedule, "
+              << blocks.tileWidth() << "x" << blocks.tileHeight() << " blocks. Busy microseconds per thread:";
     for (int i = 0; i < num_threads; ++i) {
-        threads.push_back(std::thread([&, i, rows_per_thread]() {
-            int start_row = i * rows_per_thread;
-            int end_row = (i == num_threads - 1) ? grid_height : start_row + rows_per_thread;
-
-            for (int y = start_row; y < end_row; ++y) {
-                for (int x = 0; x < grid_width; ++x) {
-                    int liveNeighbors = countLiveNeighbors(grid, x, y);
-                    if (grid[y][x] == 1) {
-                        // Cell is alive
-                        newGrid[y][x] = (liveNeighbors == 2 || liveNeighbors == 3) ? 1 : 0; // Stay alive
-                    } else {
-                        // Cell is dead
-                        newGrid[y][x] = (liveNeighbors == 3) ? 1 : 0; // Becomes alive
-                    }
-                }
-            }
-        }));
+        std::cout << " " << blocks.stats()[i].busyMicros;
+    }
+    std::cout << std::endl;
+    blocks.resetStats();
+}
+
+// Copy engine-owned cells back into grid, e.g. so it can be displayed
+void syncGrid(const Engine& engine, std::vector<std::vector<int>>& grid) {
+    if (engine.bitGrid) engine.bitGrid->unpack(grid);
+    if (engine.threadPool) engine.threadPool->unpack(grid);
+    if (engine.blockedGrid) engine.blockedGrid->unpack(grid);
+    if (engine.tileGrid) engine.tileGrid->unpack(grid);
+    if (engine.hashlife) engine.hashlife->unpack(grid);
+}
+
+// Feeds patterns straight into Hashlife, centred on the window like the grid,
+// so HASH keeps the parts of a pattern that lie outside the window. Macrocell
+// files hand over their quadtree as it is; RLE and plaintext runs are set cell by cell.
+class HashlifePatternSink : public PatternSink {
+public:
+    explicit HashlifePatternSink(Hashlife& hashlife) : m_hashlife(hashlife) {}
+
+    bool begin(const PatternHeader& header) override {
+        if (header.width > 0 && header.height > 0) {
+            m_offsetX = grid_width / 2 - header.width / 2;
+            m_offsetY = grid_height / 2 - header.height / 2;
+        }
+        return true;
+    }
+
+    bool nodes(const std::vector<MacrocellNode>& table) override {
+        m_hashlife.loadMacrocell(table, m_offsetX, m_offsetY);
+        return true;
     }
 
-    for (auto& th : threads) {
-        th.join();
+    void run(long long x, long long y, long long length, int) override {
+        for (long long i = 0; i < length; ++i) {
+            m_hashlife.setCell(x + m_offsetX + i, y + m_offsetY, true);
+        }
+        // Every setCell leaves a path of replaced nodes behind; sweep them as we go
+        if (m_hashlife.nodeCount() > static_cast<size_t>(hash_max_nodes)) m_hashlife.collectGarbage();
+    }
+
+private:
+    Hashlife& m_hashlife;
+    long long m_offsetX = 0;
+    long long m_offsetY = 0;
+};
+
+// Fill the board from the -load pattern, or randomly from the seed, and create the engine on it
+bool seedEngine(Engine& engine, std::vector<std::vector<int>>& grid) {
+    if (pattern_path.empty()) {
+        initializeGrid(grid, grid_width, grid_height, seed);
+        createEngine(engine, grid);
+        return true;
     }
 
-    grid = newGrid; // Update the original grid with the new state
+    std::ifstream file(pattern_path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Could not open " << pattern_path << std::endl;
+        return false;
+    }
+    std::string error;
+    bool loaded;
+    if (engine.type == "HASH") {
+        createEngine(engine, grid);
+        HashlifePatternSink sink(*engine.hashlife);
+        loaded = readPattern(file, patternFormatFromPath(pattern_path), sink, error);
+        syncGrid(engine, grid);
+    } else {
+        GridPatternSink sink(grid, engine.rule.states);
+        loaded = readPattern(file, patternFormatFromPath(pattern_path), sink, error);
+        createEngine(engine, grid);
+    }
+    if (!loaded) std::cerr << "Could not load " << pattern_path << ": " << error << std::endl;
+    return loaded;
 }
 
-// OpenMP processing
-void ompProcessing(std::vector<std::vector<int>>& grid, int num_threads) {
-    std::vector<std::vector<int>> newGrid(grid_height, std::vector<int>(grid_width, 0));  // Fix grid height and width ordering
+// Generations simulated after this many steps; Hashlife steps cover 2^k generations each
+long long generationOf(const Engine& engine, long long steps) {
+    if (engine.hashlife) return static_cast<long long>(engine.hashlife->generation());
+    return steps;
+}
 
-    #pragma omp parallel for collapse(2) num_threads(num_threads)
-    for (int y = 0; y < grid_height; ++y) {
-        for (int x = 0; x < grid_width; ++x) {
-            int liveNeighbors = countLiveNeighbors(grid, x, y);
-            if (grid[y][x] == 1) {  // Fix array indexing
-                // Cell is alive
-                newGrid[y][x] = (liveNeighbors == 2 || liveNeighbors == 3) ? 1 : 0;  // Stay alive
-            } else {
-                // Cell is dead
-                newGrid[y][x] = (liveNeighbors == 3) ? 1 : 0;  // Becomes alive
+// Write the current generation to the -save path, with the generation number before the extension when saving periodically.
+// Hashlife writes its whole unbounded universe rather than the window-sized grid.
+void saveSnapshot(const Engine& engine, const std::vector<std::vector<int>>& grid, long long generation, bool numbered) {
+    std::string path = snapshot_path;
+    if (numbered) {
+        size_t dot = path.find_last_of('.');
+        size_t slash = path.find_last_of("/\\");
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) dot = path.size();
+        path.insert(dot, "-" + std::to_string(generation));
+    }
+    std::string error;
+    bool saved;
+    if (engine.hashlife) {
+        // Centred on the window's centre, which is where pattern readers put the root's centre back
+        saved = saveFile(path, [&](std::ostream& out) {
+            writeMacrocellHeader(out, engine.rule);
+            engine.hashlife->writeMacrocell(out, grid_width / 2, grid_height / 2);
+        }, error);
+    } else {
+        saved = savePattern(path, grid, engine.rule, error);
+    }
+    if (!saved) {
+        std::cerr << "Snapshot failed: " << error << std::endl;
+    }
+}
+
+// Where each frame's time goes in the windowed loops; F3 shows the overlay, F4 saves a trace
+struct FrameProfiler {
+    explicit FrameProfiler(const sf::Font& font) : overlay(profiler, font) {}
+
+    void handleEvent(const sf::Event& event) {
+        if (event.type != sf::Event::KeyPressed) return;
+        if (event.key.code == sf::Keyboard::F3) visible = !visible;
+        if (event.key.code == sf::Keyboard::F4) profiler.writeChromeTrace("profile.json");
+    }
+
+    Profiler profiler;
+    ProfilerOverlay overlay;
+    bool visible = false;
+};
+
+// Display the grid using SFML; the renderer draws all live cells in a single draw call
+void displayGrid(sf::RenderWindow& window, GridRenderer& renderer, const std::vector<std::vector<int>>& grid, FrameProfiler& frame) {
+    frame.profiler.beginZone("draw");
+    window.clear();
+    renderer.draw(window, grid);
+    if (frame.visible) window.draw(frame.overlay);
+    frame.profiler.endZone();
+
+    frame.profiler.beginZone("display");
+    window.display();
+    frame.profiler.endZone();
+}
+
+// Close a frame started with Profiler::beginFrame and refresh the overlay if it is showing
+void endFrame(FrameProfiler& frame) {
+    frame.profiler.endFrame();
+    if (frame.visible) frame.overlay.update();
+}
+
+// A completed generation handed from the simulation thread to the render thread
+struct PublishedGeneration {
+    std::vector<std::vector<int>> grid;
+    long long generation = 0;
+};
+
+// Simulate on a worker thread as fast as the engine allows while this thread
+// presents the newest finished generation at whatever rate the display runs.
+// Generations are handed over through a lock-free triple buffer, and the
+// simulation only copies a generation out when the last one has been taken.
+// The profiler only times this render thread; the simulation's own rate is printed every second.
+void runPipeline(sf::RenderWindow& window, GridRenderer& renderer, Engine& engine, std::vector<std::vector<int>>& grid, FrameProfiler& frame) {
+    PublishedGeneration initial;
+    initial.grid = grid;
+    TripleBuffer<PublishedGeneration> buffer(initial);
+    std::atomic<bool> running(true);
+    std::atomic<long long> generations(0);
+
+    std::thread simulation([&]() {
+        long long generation = 0;
+        std::vector<std::vector<int>> snapshot;
+        while (running.load(std::memory_order_relaxed)) {
+            stepEngine(engine, grid);
+            generations.store(++generation, std::memory_order_relaxed);
+            if (!snapshot_path.empty() && snapshot_every > 0 && generation % snapshot_every == 0) {
+                if (ownsCells(engine) && !engine.hashlife) {
+                    snapshot = grid;
+                    syncGrid(engine, snapshot);
+                    saveSnapshot(engine, snapshot, generation, true);
+                } else {
+                    saveSnapshot(engine, grid, generationOf(engine, generation), true);
+                }
+            }
+            if (buffer.consumed()) {
+                PublishedGeneration& out = buffer.writeBuffer();
+                if (ownsCells(engine)) {
+                    syncGrid(engine, out.grid);
+                } else {
+                    out.grid = grid;
+                }
+                out.generation = generation;
+                buffer.publish();
             }
         }
+    });
+
+    auto start = std::chrono::high_resolution_clock::now();
+    long long start_generations = 0;
+    int frames = 0;
+    int fresh_frames = 0;
+
+    while (window.isOpen()) {
+        frame.profiler.beginFrame();
+
+        frame.profiler.beginZone("input");
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) window.close();
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) window.close();
+            frame.handleEvent(event);
+        }
+        frame.profiler.endZone();
+
+        if (buffer.update()) fresh_frames++;
+        displayGrid(window, renderer, buffer.readBuffer().grid, frame);
+        frames++;
+        endFrame(frame);
+
+        // Report both rates once a second
+        auto now = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsed = now - start;
+        if (elapsed.count() >= 1.0) {
+            long long total = generations.load(std::memory_order_relaxed);
+            std::cout << "Simulation: " << (total - start_generations) / elapsed.count() << " generations/s, rendering: "
+                      << frames / elapsed.count() << " frames/s (" << fresh_frames << " with a new generation), showing generation "
+                      << buffer.readBuffer().generation << "." << std::endl;
+            start = now;
+            start_generations = total;
+            frames = 0;
+            fresh_frames = 0;
+        }
     }
 
-    grid = newGrid; // Update the original grid with the new state
+    running = false;
+    simulation.join();
+
+    if (!snapshot_path.empty()) {
+        syncGrid(engine, grid);
+        saveSnapshot(engine, grid, generationOf(engine, generations.load()), false);
+    }
 }
 
-// Display the grid using SFML
-void displayGrid(sf::RenderWindow& window, const std::vector<std::vector<int>>& grid) {
-    window.clear();
-    sf::RectangleShape cellShape(sf::Vector2f(cell_size, cell_size));
-    cellShape.setFillColor(sf::Color::White);
-    for (int y = 0; y < grid.size(); ++y) {
-        for (int x = 0; x < grid[y].size(); ++x) { // Use grid[y].size() instead of grid[0].size()
-            if (grid[y][x] == 1) {
-                cellShape.setPosition(x * cell_size, y * cell_size);
-                window.draw(cellShape);
+// Run every engine/size/thread-count combination without a window and report per-generation timings
+int runBenchmark() {
+    std::vector<std::string> engines = bench_engines.empty() ? std::vector<std::string>{processing_type} : parseStringList(bench_engines);
+    std::vector<std::pair<int, int>> sizes = bench_sizes.empty() ? std::vector<std::pair<int, int>>{{grid_width, grid_height}} : parseSizeList(bench_sizes);
+    std::vector<int> thread_counts = bench_threads.empty() ? std::vector<int>{num_threads} : parseIntList(bench_threads);
+    std::vector<std::string> schedules = bench_schedules.empty() ? std::vector<std::string>{schedule_name} : parseStringList(bench_schedules);
+
+    // Rulestrings can contain commas, so the rule list is separated by semicolons
+    std::vector<Rule> rules;
+    for (const auto& text : bench_rules.empty() ? std::vector<std::string>{rule.name()} : parseStringList(bench_rules, ';')) {
+        Rule parsed;
+        std::string error;
+        if (Rule::parse(text, parsed, error)) {
+            rules.push_back(parsed);
+        } else {
+            std::cerr << "Skipping rule " << text << ": " << error << std::endl;
+        }
+    }
+
+    std::vector<BenchmarkResult> results;
+    for (const auto& type : engines) {
+        if (type != "SEQ" && type != "THRD" && type != "OMP" && type != "SIMD" && type != "TILE" && type != "HASH") {
+            std::cerr << "Skipping unknown engine " << type << std::endl;
+            continue;
+        }
+        // Single-threaded engines are only run once per size
+        std::vector<int> counts = (type == "SEQ" || type == "SIMD" || type == "TILE" || type == "HASH") ? std::vector<int>{1} : thread_counts;
+
+        // Only the blocked engines have a schedule to sweep
+        bool blocked = (type == "THRD" || type == "OMP");
+        std::vector<std::string> schedule_list = blocked ? schedules : std::vector<std::string>{schedule_name};
+
+        for (const auto& bench_rule : rules) {
+            if (!bench_rule.isConway() && (type == "SIMD" || type == "TILE" || type == "HASH")) {
+                std::cerr << "Skipping " << type << " for " << bench_rule.name() << ": only B3/S23 is supported" << std::endl;
+                continue;
+            }
+            for (const auto& size : sizes) {
+                for (int threads : counts) {
+                    for (const auto& schedule : schedule_list) {
+                        grid_width = size.first;
+                        grid_height = size.second;
+                        std::vector<std::vector<int>> grid(grid_height, std::vector<int>(grid_width));
+
+                        Engine engine;
+                        engine.type = type;
+                        engine.threads = std::max(threads, 1);
+                        engine.schedule = BlockedGrid::parseSchedule(schedule);
+                        engine.rule = bench_rule;
+                        if (!seedEngine(engine, grid)) return 1;
+
+                        std::vector<double> samples;
+                        samples.reserve(bench_generations);
+                        for (int g = 0; g < bench_generations; ++g) {
+                            auto start = std::chrono::high_resolution_clock::now();
+                            stepEngine(engine, grid);
+                            auto end = std::chrono::high_resolution_clock::now();
+                            samples.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+                        }
+
+                        syncGrid(engine, grid);
+                        BenchmarkResult result;
+                        result.engine = type;
+                        result.rule = bench_rule.name();
+                        result.width = grid_width;
+                        result.height = grid_height;
+                        result.threads = engine.threads;
+                        result.seed = seed;
+                        if (engine.hashlife) result.generationsPerStep = 1LL << engine.hashlife->stepExponent();
+                        if (BlockedGrid* blocks = blockedGridOf(engine)) {
+                            result.schedule = BlockedGrid::scheduleName(blocks->schedule());
+                            result.tileWidth = blocks->tileWidth();
+                            result.tileHeight = blocks->tileHeight();
+                            for (int i = 0; i < engine.threads; ++i) {
+                                const WorkerStats& stats = blocks->stats()[i];
+                                result.threadBusyMicros.push_back(stats.busyMicros);
+                                result.threadTiles.push_back(stats.tiles);
+                                result.steals += stats.steals;
+                            }
+                        }
+                        for (const auto& row : grid) {
+                            for (int cell : row) result.finalPopulation += (cell == 1);
+                        }
+                        summarizeGenerations(result, samples);
+                        results.push_back(result);
+
+                        std::cerr << type << " " << grid_width << "x" << grid_height << " " << engine.threads
+                                  << " threads " << result.schedule << " " << result.rule << ": " << result.meanMicros << " us/generation" << std::endl;
+                    }
+                }
             }
         }
     }
-    window.display();
+
+    std::ofstream file;
+    if (!bench_output.empty()) {
+        file.open(bench_output);
+        if (!file) {
+            std::cerr << "Could not open " << bench_output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = bench_output.empty() ? std::cout : file;
+    if (bench_format == "json") {
+        writeBenchmarkJson(out, results);
+    } else {
+        writeBenchmarkCsv(out, results);
+    }
+    return 0;
 }
 
 int main(int argc, char* argv[]) {
     // Parse command line arguments
     parseCommandLine(argc, argv);
 
-    // Initialize the grid
     grid_width = window_width / cell_size;
     grid_height = window_height / cell_size;
+
+    if (!pattern_path.empty() && !rule_given) adoptPatternRule();
+    checkEngineSupportsRule();
+
+    // Only macrocell holds a quadtree; any other format would cut the universe down to the window
+    if (processing_type == "HASH" && !snapshot_path.empty() && patternFormatFromPath(snapshot_path) != PatternFormat::Macrocell) {
+        std::cerr << "HASH snapshots need a .mc path to keep the cells outside the window, not saving " << snapshot_path << std::endl;
+        snapshot_path.clear();
+    }
+
+    // Headless mode never opens a window
+    if (headless) {
+        return runBenchmark();
+    }
+
+    // Initialize the grid
     std::vector<std::vector<int>> grid(grid_height, std::vector<int>(grid_width));
-    initializeGrid(grid, grid_width, grid_height);
+
+    Engine engine;
+    engine.type = processing_type;
+    engine.threads = num_threads;
+    engine.schedule = BlockedGrid::parseSchedule(schedule_name);
+    engine.rule = rule;
+    if (!seedEngine(engine, grid)) return 1;
+    std::cout << "Running " << rule.name() << " with the " << processing_type << " engine." << std::endl;
 
     // Create the window
     sf::RenderWindow window(sf::VideoMode(window_width, window_height), "Game of Life");
+    GridRenderer renderer(grid_width, grid_height, cell_size, GridRenderer::parseMode(render_mode));
+
+    sf::Font font;
+    font.loadFromFile("fonts/KOMIKAP_.ttf");
+    FrameProfiler frame(font);
+    frame.overlay.setPosition(window_width - 370.f, 10.f);
+
+    if (pipelined) {
+        runPipeline(window, renderer, engine, grid, frame);
+        return 0;
+    }
 
     auto start = std::chrono::high_resolution_clock::now();
     int generations = 0;
 
     // Game loop
     while (window.isOpen()) {
+        frame.profiler.beginFrame();
+
+        frame.profiler.beginZone("input");
         sf::Event event;
         while (window.pollEvent(event)) {
             if (event.type == sf::Event::Closed) window.close();
             if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) window.close();
+            frame.handleEvent(event);
         }
+        frame.profiler.endZone();
 
         // Process grid
-        if (processing_type == "SEQ") {
-            sequentialProcessing(grid);
-        } else if (processing_type == "THRD") {
-            multithreadedProcessing(grid, num_threads);
-        } else if (processing_type == "OMP") {
-            ompProcessing(grid, num_threads);
-        }
+        frame.profiler.beginZone("step");
+        stepEngine(engine, grid);
+        frame.profiler.endZone();
 
         // Display the grid
-        displayGrid(window, grid);
+        frame.profiler.beginZone("sync");
+        syncGrid(engine, grid);
+        frame.profiler.endZone();
+        displayGrid(window, renderer, grid, frame);
 
         generations++;
 
+        if (!snapshot_path.empty() && snapshot_every > 0 && generations % snapshot_every == 0) {
+            frame.profiler.beginZone("snapshot");
+            saveSnapshot(engine, grid, generationOf(engine, generations), true);
+            frame.profiler.endZone();
+        }
+        endFrame(frame);
+
         // Output the processing time every 100 generations
         if (generations % 100 == 0) {
             auto end = std::chrono::high_resolution_clock::now();
@@ -214,10 +732,20 @@ int main(int argc, char* argv[]) {
 
             if (processing_type == "SEQ") {
                 std::cout << "single thread." << std::endl;
+            } else if (processing_type == "SIMD") {
+                std::cout << "single thread " << BitGrid::backendName() << " bit-packed." << std::endl;
+            } else if (processing_type == "TILE") {
+                std::cout << "single thread, " << engine.tileGrid->activeTiles() << " of "
+                          << engine.tileGrid->tileCount() << " tiles active." << std::endl;
+            } else if (processing_type == "HASH") {
+                std::cout << "Hashlife, generation " << engine.hashlife->generation() << ", population "
+                          << engine.hashlife->population() << ", " << engine.hashlife->nodeCount() << " nodes." << std::endl;
             } else if (processing_type == "OMP") {
-                std::cout << num_threads << " OMP threads." << std::endl;
+                std::cout << num_threads << " OMP threads";
+                printThreadStats(*blockedGridOf(engine), num_threads);
             } else {
-                std::cout << num_threads << " std::threads." << std::endl;
+                std::cout << num_threads << " std::threads";
+                printThreadStats(*blockedGridOf(engine), num_threads);
             }
 
             start = std::chrono::high_resolution_clock::now();  // Reset timer
@@ -227,5 +755,10 @@ int main(int argc, char* argv[]) {
         //std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 
+    // Checkpoint the last generation under the plain -save name
+    if (!snapshot_path.empty()) {
+        saveSnapshot(engine, grid, generationOf(engine, generations), false);
+    }
+
     return 0;
-}
\ No newline at end of file
+}
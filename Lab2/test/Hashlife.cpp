@@ -0,0 +1,74 @@
+#include "Hashlife.h"
+#include "PatternIO.h"
+
+#include <catch.hpp>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+// Loads a macrocell file with the centre of its root at (centreX, centreY),
+// the way Lab2 centres patterns on the window
+class CentredMacrocellSink : public PatternSink {
+public:
+    CentredMacrocellSink(Hashlife& hashlife, long long centreX, long long centreY)
+        : m_hashlife(hashlife), m_centreX(centreX), m_centreY(centreY) {}
+
+    bool begin(const PatternHeader& header) override {
+        m_half = header.width / 2;
+        return true;
+    }
+
+    bool nodes(const std::vector<MacrocellNode>& table) override {
+        m_hashlife.loadMacrocell(table, m_centreX - m_half, m_centreY - m_half);
+        return true;
+    }
+
+    void run(long long, long long, long long, int) override {
+        ++runs;
+    }
+
+    int runs = 0;
+
+private:
+    Hashlife& m_hashlife;
+    long long m_centreX;
+    long long m_centreY;
+    long long m_half = 0;
+};
+
+} // namespace
+
+TEST_CASE("Hashlife loads macrocell node tables", "[Hashlife]") {
+    const long long cells[][2] = {{0, 0}, {1, 0}, {2, 0}, {51, -50}, {52, -49}, {50, -48}, {51, -48}, {52, -48}, {-40, -33}, {100, 64}, {99, 65}};
+
+    Hashlife original;
+    for (const auto& cell : cells) {
+        original.setCell(cell[0], cell[1], true);
+    }
+    original.setStepExponent(2);
+    original.step();
+
+    // An odd centre, so the written root does not line up with either universe's nodes
+    const long long centreX = 37;
+    const long long centreY = -11;
+    std::stringstream file;
+    file << "[M2]\n";
+    original.writeMacrocell(file, centreX, centreY);
+
+    Hashlife loaded;
+    CentredMacrocellSink sink(loaded, centreX, centreY);
+    std::string error;
+    REQUIRE(readPattern(file, PatternFormat::Macrocell, sink, error));
+
+    CHECK(sink.runs == 0);
+    CHECK(loaded.generation() == 0);
+    CHECK(loaded.population() == original.population());
+    bool same = true;
+    for (long long y = -100; y < 140; ++y) {
+        for (long long x = -100; x < 160; ++x) {
+            same = same && loaded.getCell(x, y) == original.getCell(x, y);
+        }
+    }
+    CHECK(same);
+}
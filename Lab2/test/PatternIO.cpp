@@ -0,0 +1,82 @@
+#include "PatternIO.h"
+
+#include <catch.hpp>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+struct Run {
+    long long x, y, length;
+    int state;
+};
+
+class RecordingSink : public PatternSink {
+public:
+    bool begin(const PatternHeader& begun) override {
+        header = begun;
+        return true;
+    }
+    void run(long long x, long long y, long long length, int state) override {
+        runs.push_back({x, y, length, state});
+    }
+
+    PatternHeader header;
+    std::vector<Run> runs;
+};
+
+bool read(const std::string& text, PatternFormat format, RecordingSink& sink) {
+    std::istringstream in(text);
+    std::string error;
+    bool ok = readPattern(in, format, sink, error);
+    INFO(error);
+    return ok;
+}
+
+} // namespace
+
+TEST_CASE("RLE patterns are read", "[PatternIO]") {
+    const std::string glider = "x = 3, y = 3, rule = B3/S23\nbob$2bo$3o!\n";
+
+    SECTION("Header and runs") {
+        RecordingSink sink;
+        REQUIRE(read(glider, PatternFormat::Rle, sink));
+        CHECK(sink.header.width == 3);
+        CHECK(sink.header.height == 3);
+        CHECK(sink.header.rule == "B3/S23");
+        REQUIRE(sink.runs.size() == 3);
+        CHECK(sink.runs[0].x == 1);
+        CHECK(sink.runs[0].y == 0);
+        CHECK(sink.runs[1].x == 2);
+        CHECK(sink.runs[1].y == 1);
+        CHECK(sink.runs[2].x == 0);
+        CHECK(sink.runs[2].y == 2);
+        CHECK(sink.runs[2].length == 3);
+    }
+
+    SECTION("Comment and blank lines before the header") {
+        RecordingSink sink;
+        REQUIRE(read("\n#N Glider\r\n\r\n  \n" + glider, PatternFormat::Rle, sink));
+        CHECK(sink.header.width == 3);
+        CHECK(sink.header.height == 3);
+        CHECK(sink.header.rule == "B3/S23");
+        CHECK(sink.runs.size() == 3);
+    }
+
+    SECTION("Old #r rule line") {
+        RecordingSink sink;
+        REQUIRE(read("#r 23/3\n\nbo!\n", PatternFormat::Rle, sink));
+        CHECK(sink.header.rule == "23/3");
+        REQUIRE(sink.runs.size() == 1);
+        CHECK(sink.runs[0].x == 1);
+    }
+
+    SECTION("Header only") {
+        std::istringstream in("\n" + glider);
+        PatternHeader header;
+        std::string error;
+        REQUIRE(readPatternHeader(in, PatternFormat::Rle, header, error));
+        CHECK(header.width == 3);
+        CHECK(header.rule == "B3/S23");
+    }
+}
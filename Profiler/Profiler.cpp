@@ -0,0 +1,134 @@
+#include "Profiler.h"
+
+#include <fstream>
+
+Profiler::Profiler(int historySize) : m_frames(historySize > 0 ? historySize : 1)
+{
+    // Room for a busy frame's zones up front, so profiling does not allocate
+    for (Frame& frame : m_frames)
+    {
+        frame.zones.reserve(64);
+    }
+}
+
+void Profiler::beginFrame()
+{
+    Frame& frame = m_frames[m_frameCount % m_frames.size()];
+    frame.zones.clear();
+    frame.start = m_clock.getElapsedTime().asMicroseconds();
+    frame.end = frame.start;
+    m_inFrame = true;
+    m_depth = 0;
+    m_skippedDepth = 0;
+}
+
+void Profiler::endFrame()
+{
+    if (!m_inFrame)
+    {
+        return;
+    }
+
+    Frame& frame = m_frames[m_frameCount % m_frames.size()];
+    frame.end = m_clock.getElapsedTime().asMicroseconds();
+
+    // Close anything left open, e.g. by an early continue
+    while (m_depth > 0)
+    {
+        frame.zones[m_open[--m_depth]].end = frame.end;
+    }
+
+    m_inFrame = false;
+    ++m_frameCount;
+}
+
+void Profiler::beginZone(const char* name)
+{
+    if (!m_inFrame || m_depth == MAX_DEPTH || m_skippedDepth > 0)
+    {
+        ++m_skippedDepth;
+        return;
+    }
+
+    Frame& frame = m_frames[m_frameCount % m_frames.size()];
+    sf::Int64 now = m_clock.getElapsedTime().asMicroseconds();
+    m_open[m_depth] = static_cast<int>(frame.zones.size());
+    frame.zones.push_back({name, m_depth, now, now});
+    ++m_depth;
+}
+
+void Profiler::endZone()
+{
+    if (m_skippedDepth > 0)
+    {
+        --m_skippedDepth;
+        return;
+    }
+
+    if (!m_inFrame || m_depth == 0)
+    {
+        return;
+    }
+
+    Frame& frame = m_frames[m_frameCount % m_frames.size()];
+    frame.zones[m_open[--m_depth]].end = m_clock.getElapsedTime().asMicroseconds();
+}
+
+const Profiler::Frame& Profiler::getFrame(int age) const
+{
+    int index = (m_frameCount - 1 - age) % static_cast<int>(m_frames.size());
+    return m_frames[index < 0 ? index + m_frames.size() : index];
+}
+
+namespace
+{
+    // Zone names are identifiers in practice, but keep the JSON valid whatever they are
+    void writeJsonString(std::ofstream& out, const char* text)
+    {
+        out << '"';
+        for (const char* c = text; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                out << '\\' << *c;
+            }
+            else if (static_cast<unsigned char>(*c) >= 0x20)
+            {
+                out << *c;
+            }
+        }
+        out << '"';
+    }
+
+    void writeEvent(std::ofstream& out, bool& first, const char* name, sf::Int64 start, sf::Int64 end)
+    {
+        out << (first ? "\n" : ",\n") << "{\"name\":";
+        writeJsonString(out, name);
+        out << ",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << start << ",\"dur\":" << (end - start) << "}";
+        first = false;
+    }
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const
+{
+    std::ofstream out(path);
+    if (!out)
+    {
+        return false;
+    }
+
+    // Complete ("X") events in microseconds; nesting comes from the times
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (int age = getFrameCount() - 1; age >= 0; --age)
+    {
+        const Frame& frame = getFrame(age);
+        writeEvent(out, first, "frame", frame.start, frame.end);
+        for (const Zone& zone : frame.zones)
+        {
+            writeEvent(out, first, zone.name, zone.start, zone.end);
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return static_cast<bool>(out);
+}
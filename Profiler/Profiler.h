@@ -0,0 +1,99 @@
+#pragma once
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/Config.hpp>
+#include <string>
+#include <vector>
+
+// Frame profiler shared by the games. A frame is split into named zones
+// (input, update, draw, ...) that can nest; each zone is timed with the
+// profiler's sf::Clock and the last few hundred frames are kept in a ring
+// buffer for ProfilerOverlay to draw or writeChromeTrace() to save.
+//
+//     profiler.beginFrame();
+//     {
+//         ProfileScope zone(profiler, "update");
+//         ...
+//     }
+//     profiler.endFrame();
+//
+// Zone names must be string literals (or otherwise outlive the profiler);
+// they are kept as pointers so timing a frame never allocates once the
+// ring buffer has warmed up.
+class Profiler
+{
+public:
+    struct Zone
+    {
+        const char* name;
+        int depth;         // 0 for zones directly inside the frame
+        sf::Int64 start;   // microseconds since the profiler was created
+        sf::Int64 end;
+    };
+
+    struct Frame
+    {
+        sf::Int64 start = 0;
+        sf::Int64 end = 0;
+        std::vector<Zone> zones;  // in the order they began
+
+        sf::Int64 duration() const
+        {
+            return end - start;
+        }
+    };
+
+    explicit Profiler(int historySize = 240);
+
+    void beginFrame();
+    void endFrame();
+
+    // Zones opened outside a frame, or nested deeper than MAX_DEPTH, are ignored
+    void beginZone(const char* name);
+    void endZone();
+
+    // Completed frames in the ring buffer
+    int getFrameCount() const
+    {
+        return m_frameCount < static_cast<int>(m_frames.size()) ? m_frameCount : static_cast<int>(m_frames.size());
+    }
+
+    // A completed frame; age 0 is the most recent
+    const Frame& getFrame(int age) const;
+
+    // Save the buffered frames in Chrome's trace event format, for
+    // chrome://tracing or ui.perfetto.dev
+    bool writeChromeTrace(const std::string& path) const;
+
+private:
+    static const int MAX_DEPTH = 16;
+
+    sf::Clock m_clock;
+    std::vector<Frame> m_frames;
+    int m_frameCount = 0;     // frames completed since the start
+    bool m_inFrame = false;
+    int m_open[MAX_DEPTH];    // indices into the current frame's zones
+    int m_depth = 0;
+    int m_skippedDepth = 0;   // zones ignored for being too deep, still to be closed
+};
+
+// Times the enclosing scope as a zone
+class ProfileScope
+{
+public:
+    ProfileScope(Profiler& profiler, const char* name) : m_profiler(profiler)
+    {
+        m_profiler.beginZone(name);
+    }
+
+    ~ProfileScope()
+    {
+        m_profiler.endZone();
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profiler& m_profiler;
+};
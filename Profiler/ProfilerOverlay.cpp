@@ -0,0 +1,154 @@
+#include "ProfilerOverlay.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+    const float GRAPH_WIDTH = 360;
+    const float GRAPH_HEIGHT = 100;
+    const float MICROSECONDS_PER_PIXEL = 33333.f / GRAPH_HEIGHT;  // The graph tops out at 30 fps
+    const float TABLE_TOP = GRAPH_HEIGHT + 8;
+
+    // Colours for the top-level zones, in the order they first appear in a frame
+    const sf::Color ZONE_COLORS[] = {
+        sf::Color(80, 160, 255), sf::Color(255, 170, 60), sf::Color(120, 220, 100),
+        sf::Color(230, 90, 200), sf::Color(240, 230, 90), sf::Color(90, 220, 220),
+    };
+    const int ZONE_COLOR_COUNT = sizeof(ZONE_COLORS) / sizeof(ZONE_COLORS[0]);
+
+    float toHeight(sf::Int64 microseconds)
+    {
+        return std::min(GRAPH_HEIGHT, microseconds / MICROSECONDS_PER_PIXEL);
+    }
+
+    void addQuad(sf::VertexArray& vertices, float left, float top, float right, float bottom, sf::Color color)
+    {
+        vertices.append(sf::Vertex(sf::Vector2f(left, top), color));
+        vertices.append(sf::Vertex(sf::Vector2f(right, top), color));
+        vertices.append(sf::Vertex(sf::Vector2f(right, bottom), color));
+        vertices.append(sf::Vertex(sf::Vector2f(left, bottom), color));
+    }
+}
+
+ProfilerOverlay::ProfilerOverlay(const Profiler& profiler, const sf::Font& font)
+    : m_profiler(profiler), m_bars(sf::Quads), m_budgets(sf::Lines), m_table("", font, 14)
+{
+    m_background.setFillColor(sf::Color(0, 0, 0, 170));
+    m_background.setSize(sf::Vector2f(GRAPH_WIDTH, TABLE_TOP));
+    m_table.setPosition(4, TABLE_TOP);
+
+    // Lines at the 60 and 120 Hz frame budgets
+    const float budgets[] = {16667, 8333};
+    for (float budget : budgets)
+    {
+        float y = GRAPH_HEIGHT - toHeight(static_cast<sf::Int64>(budget));
+        m_budgets.append(sf::Vertex(sf::Vector2f(0, y), sf::Color(255, 255, 255, 120)));
+        m_budgets.append(sf::Vertex(sf::Vector2f(GRAPH_WIDTH, y), sf::Color(255, 255, 255, 120)));
+    }
+}
+
+void ProfilerOverlay::update()
+{
+    rebuildGraph();
+    if (m_tableClock.getElapsedTime() >= sf::seconds(0.5f))
+    {
+        m_tableClock.restart();
+        rebuildTable();
+    }
+}
+
+void ProfilerOverlay::rebuildGraph()
+{
+    m_bars.clear();
+    int count = m_profiler.getFrameCount();
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Newest frame on the right, each bar stacked from its top-level zones
+    // with the untracked remainder in grey on top
+    float barWidth = GRAPH_WIDTH / count;
+    for (int age = 0; age < count; ++age)
+    {
+        const Profiler::Frame& frame = m_profiler.getFrame(age);
+        float right = GRAPH_WIDTH - age * barWidth;
+        float left = right - std::max(barWidth - 1, 1.f);
+        float bottom = GRAPH_HEIGHT;
+        sf::Int64 tracked = 0;
+        int colorIndex = 0;
+        for (const Profiler::Zone& zone : frame.zones)
+        {
+            if (zone.depth != 0)
+            {
+                continue;
+            }
+            float top = GRAPH_HEIGHT - toHeight(tracked + zone.end - zone.start);
+            addQuad(m_bars, left, top, right, bottom, ZONE_COLORS[colorIndex++ % ZONE_COLOR_COUNT]);
+            tracked += zone.end - zone.start;
+            bottom = top;
+        }
+        addQuad(m_bars, left, GRAPH_HEIGHT - toHeight(frame.duration()), right, bottom, sf::Color(128, 128, 128));
+    }
+}
+
+void ProfilerOverlay::rebuildTable()
+{
+    // Sum every zone by name and depth, keeping first-seen order, which
+    // follows the nesting of the zones within a frame
+    m_summaries.clear();
+    sf::Int64 frameTotal = 0;
+    sf::Int64 frameWorst = 0;
+    int count = m_profiler.getFrameCount();
+    for (int age = count - 1; age >= 0; --age)
+    {
+        const Profiler::Frame& frame = m_profiler.getFrame(age);
+        frameTotal += frame.duration();
+        frameWorst = std::max(frameWorst, frame.duration());
+
+        size_t insertAt = 0;
+        for (const Profiler::Zone& zone : frame.zones)
+        {
+            auto found = std::find_if(m_summaries.begin(), m_summaries.end(), [&](const ZoneSummary& summary)
+            {
+                return summary.depth == zone.depth && std::strcmp(summary.name, zone.name) == 0;
+            });
+
+            sf::Int64 duration = zone.end - zone.start;
+            if (found == m_summaries.end())
+            {
+                found = m_summaries.insert(m_summaries.begin() + std::min(insertAt, m_summaries.size()),
+                                           ZoneSummary{zone.name, zone.depth, 0, 0});
+            }
+            found->total += duration;
+            found->worst = std::max(found->worst, duration);
+            insertAt = (found - m_summaries.begin()) + 1;
+        }
+    }
+
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2);
+    if (count > 0)
+    {
+        text << "frame  " << frameTotal / 1000.0 / count << " ms  (worst " << frameWorst / 1000.0 << ")\n";
+        for (const ZoneSummary& summary : m_summaries)
+        {
+            text << std::string(2 + 2 * summary.depth, ' ') << summary.name << "  " << summary.total / 1000.0 / count
+                 << " ms  (worst " << summary.worst / 1000.0 << ")\n";
+        }
+    }
+    m_table.setString(text.str());
+    m_background.setSize(sf::Vector2f(GRAPH_WIDTH, TABLE_TOP + m_table.getLocalBounds().height + 12));
+}
+
+void ProfilerOverlay::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    states.transform *= getTransform();
+    target.draw(m_background, states);
+    target.draw(m_bars, states);
+    target.draw(m_budgets, states);
+    target.draw(m_table, states);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include "Profiler.h"
+
+// On-screen view of a Profiler: a bar per recent frame, stacked by top-level
+// zone and scaled against 60 and 120 Hz frame budgets, so spikes stand out,
+// and a table of each zone's average and worst time over the buffered frames.
+//
+// Call update() once per frame after Profiler::endFrame(); the table is only
+// rebuilt a few times a second so the overlay stays cheap to leave on.
+class ProfilerOverlay : public sf::Drawable, public sf::Transformable
+{
+public:
+    ProfilerOverlay(const Profiler& profiler, const sf::Font& font);
+
+    void update();
+
+private:
+    struct ZoneSummary
+    {
+        const char* name;
+        int depth;
+        sf::Int64 total;
+        sf::Int64 worst;
+    };
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void rebuildGraph();
+    void rebuildTable();
+
+    const Profiler& m_profiler;
+    sf::RectangleShape m_background;
+    sf::VertexArray m_bars;
+    sf::VertexArray m_budgets;
+    sf::Text m_table;
+    sf::Clock m_tableClock;
+    std::vector<ZoneSummary> m_summaries;
+};
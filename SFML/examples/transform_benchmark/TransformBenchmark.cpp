@@ -0,0 +1,84 @@
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////
+/// Time one way of transforming the vertices, in nanoseconds per vertex
+///
+////////////////////////////////////////////////////////////
+template <typename Function>
+double measure(std::vector<sf::Vertex>& vertices, const sf::Transform& transform, Function function, int repeats)
+{
+    sf::Clock clock;
+    for (int i = 0; i < repeats; ++i)
+        function(vertices, transform);
+
+    return static_cast<double>(clock.getElapsedTime().asMicroseconds()) * 1000.0 / (static_cast<double>(vertices.size()) * repeats);
+}
+
+
+////////////////////////////////////////////////////////////
+/// One call to transformPoint per vertex, like a hand-written loop
+///
+////////////////////////////////////////////////////////////
+void transformOneByOne(std::vector<sf::Vertex>& vertices, const sf::Transform& transform)
+{
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+        vertices[i].position = transform.transformPoint(vertices[i].position);
+}
+
+
+////////////////////////////////////////////////////////////
+/// The whole array at once
+///
+////////////////////////////////////////////////////////////
+void transformInBulk(std::vector<sf::Vertex>& vertices, const sf::Transform& transform)
+{
+    transform.transformPoints(&vertices[0], vertices.size());
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    // Rotating around the centre keeps the points in range however often they are transformed
+    sf::Transform transform;
+    transform.rotate(0.5f, 500.f, 500.f);
+
+    const std::size_t counts[] = {4, 64, 1024, 100000};
+    for (std::size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+    {
+        std::vector<sf::Vertex> vertices(counts[c]);
+        for (std::size_t i = 0; i < vertices.size(); ++i)
+            vertices[i].position = sf::Vector2f(static_cast<float>(i % 1000), static_cast<float>(i / 1000));
+
+        // About the same amount of work for every count
+        int repeats = static_cast<int>(20000000 / counts[c]);
+
+        // Warm up the caches before timing anything
+        transformOneByOne(vertices, transform);
+
+        double oneByOne = measure(vertices, transform, transformOneByOne, repeats);
+        double inBulk   = measure(vertices, transform, transformInBulk, repeats);
+
+        std::cout << counts[c] << " vertices:" << std::endl;
+        std::cout << " transformPoint  " << oneByOne << " ns / vertex" << std::endl;
+        std::cout << " transformPoints " << inBulk   << " ns / vertex" << std::endl;
+
+        // Print a result so that the compiler can't throw the work away
+        std::cout << " (last vertex at " << vertices.back().position.x << ", " << vertices.back().position.y << ")" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
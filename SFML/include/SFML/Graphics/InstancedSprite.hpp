@@ -0,0 +1,329 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+#ifndef SFML_INSTANCEDSPRITE_HPP
+#define SFML_INSTANCEDSPRITE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Window/GlResource.hpp>
+#include <vector>
+
+
+namespace sf
+{
+class RenderTarget;
+class Shader;
+class Texture;
+
+////////////////////////////////////////////////////////////
+/// \brief Many copies of a textured quad, drawn with a single draw call
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API InstancedSprite : public Drawable, private GlResource
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty set of instances with no source texture.
+    ///
+    ////////////////////////////////////////////////////////////
+    InstancedSprite();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the instances from a source texture
+    ///
+    /// \param texture Source texture
+    ///
+    /// \see setTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit InstancedSprite(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy constructor
+    ///
+    /// \param copy instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    InstancedSprite(const InstancedSprite& copy);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~InstancedSprite();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Overload of assignment operator
+    ///
+    /// \param right Instance to assign
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    InstancedSprite& operator =(const InstancedSprite& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the source texture shared by all the instances
+    ///
+    /// The \a texture argument refers to a texture that must
+    /// exist as long as the instances use it.
+    ///
+    /// \param texture New texture
+    ///
+    /// \see getTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTexture(const Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the source texture shared by all the instances
+    ///
+    /// \return Pointer to the texture, or NULL if there is none
+    ///
+    /// \see setTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    const Texture* getTexture() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an instance at the end
+    ///
+    /// The instance is a quad of the size of \a textureRect,
+    /// placed by \a transform exactly like a sf::Sprite with the
+    /// same texture rect and the same transform.
+    ///
+    /// \param transform   Transform of the instance
+    /// \param textureRect Sub-rectangle of the texture to display
+    /// \param color       Color modulated with the texture
+    ///
+    /// \return Index of the new instance
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t append(const Transform& transform, const IntRect& textureRect, const Color& color = Color::White);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change everything about an existing instance
+    ///
+    /// \param index       Index of the instance, in range [0 .. getInstanceCount() - 1]
+    /// \param transform   Transform of the instance
+    /// \param textureRect Sub-rectangle of the texture to display
+    /// \param color       Color modulated with the texture
+    ///
+    ////////////////////////////////////////////////////////////
+    void setInstance(std::size_t index, const Transform& transform, const IntRect& textureRect, const Color& color = Color::White);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the transform of an existing instance
+    ///
+    /// \param index     Index of the instance, in range [0 .. getInstanceCount() - 1]
+    /// \param transform New transform of the instance
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTransform(std::size_t index, const Transform& transform);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the texture rect of an existing instance
+    ///
+    /// \param index       Index of the instance, in range [0 .. getInstanceCount() - 1]
+    /// \param textureRect New sub-rectangle of the texture to display
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTextureRect(std::size_t index, const IntRect& textureRect);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the color of an existing instance
+    ///
+    /// \param index Index of the instance, in range [0 .. getInstanceCount() - 1]
+    /// \param color New color of the instance
+    ///
+    ////////////////////////////////////////////////////////////
+    void setColor(std::size_t index, const Color& color);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the number of instances
+    ///
+    /// \return Number of instances
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getInstanceCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Resize the set of instances
+    ///
+    /// New instances show the whole texture, untransformed
+    /// and with an opaque white color.
+    ///
+    /// \param instanceCount New number of instances
+    ///
+    ////////////////////////////////////////////////////////////
+    void resize(std::size_t instanceCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the instances
+    ///
+    /// The memory is kept, so that adding instances again
+    /// doesn't reallocate anything.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether or not the system supports instanced drawing
+    ///
+    /// Instanced drawing requires OpenGL 3.3 and shaders. When
+    /// it isn't supported, the instances are still drawn, but
+    /// their quads are built on the CPU and drawn as a regular
+    /// array of vertices.
+    ///
+    /// \return True if instanced drawing is supported, false otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+private:
+
+    friend class RenderTarget;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the instances to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(RenderTarget& target, RenderStates states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get ready for an instanced draw
+    ///
+    /// Gets the built-in shader on first use, compiling it if
+    /// no other instanced sprite did, and uploads the instances
+    /// that changed since the last draw.
+    ///
+    /// \return False if instanced drawing can't be used
+    ///
+    ////////////////////////////////////////////////////////////
+    bool prepareInstancing() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bind or unbind the per-instance vertex attributes
+    ///
+    /// \param bind True to bind the attributes, false to unbind them
+    ///
+    ////////////////////////////////////////////////////////////
+    void bindInstanceAttributes(bool bind) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the instances expanded to triangles on the CPU
+    ///
+    /// \return Array of 6 vertices per instance
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::vector<Vertex>& getVertices() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Data of one instance, as sent to the graphics card
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Instance
+    {
+        float row0[3];        //!< First row of the 2D affine transform
+        float row1[3];        //!< Second row of the 2D affine transform
+        float textureRect[4]; //!< Texture rect (left, top, width, height), in pixels
+        Color color;          //!< Color modulated with the texture
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    const Texture*              m_texture;            //!< Texture shared by all the instances
+    std::vector<Instance>       m_instances;          //!< Per-instance data
+    mutable std::vector<Vertex> m_vertices;           //!< Instances expanded on the CPU, when instancing isn't used
+    mutable bool                m_verticesNeedUpdate; //!< Do the expanded vertices need to be rebuilt?
+    mutable unsigned int        m_buffer;             //!< OpenGL buffer holding the per-instance data
+    mutable bool                m_bufferNeedsUpdate;  //!< Does the buffer need to be uploaded again?
+    mutable const Shader*       m_shader;             //!< Built-in shader shared by all the instanced sprites, NULL until this one uses it
+    mutable int                 m_attributes[4];      //!< Locations of row0, row1, textureRect and color in the shader
+};
+
+} // namespace sf
+
+
+#endif // SFML_INSTANCEDSPRITE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::InstancedSprite
+/// \ingroup graphics
+///
+/// sf::InstancedSprite draws the same texture many times, each
+/// copy (instance) with its own transform, texture rect and color.
+/// Each instance looks exactly like a sf::Sprite with the same
+/// texture rect, color and transform, but all of them are drawn
+/// with a single draw call, which makes it possible to render
+/// hundreds of thousands of quads per frame for particles or
+/// bullets.
+///
+/// When the system supports it (see isAvailable()), only one quad
+/// and the per-instance data are sent to the graphics card, and a
+/// built-in shader places the quads. That shader is compiled once
+/// and shared by all the instanced sprites. Otherwise, the quads are built
+/// on the CPU and drawn as an array of triangles; the result on
+/// screen is the same. A custom shader in the render states also
+/// selects the CPU path, since the built-in one has to be used for
+/// instancing.
+///
+/// Per-instance data is uploaded again only when it changed since
+/// the previous draw.
+///
+/// Usage example:
+/// \code
+/// sf::InstancedSprite bullets(texture);
+/// for (std::size_t i = 0; i < 10000; ++i)
+/// {
+///     sf::Transform transform;
+///     transform.translate(positions[i]).rotate(angles[i]);
+///     bullets.append(transform, sf::IntRect(0, 0, 8, 8));
+/// }
+///
+/// // Every frame, move the bullets that changed
+/// bullets.setTransform(index, newTransform);
+///
+/// window.draw(bullets);
+/// \endcode
+///
+/// \see sf::Sprite, sf::VertexBuffer
+///
+////////////////////////////////////////////////////////////
@@ -0,0 +1,257 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_RENDERQUEUE_HPP
+#define SFML_RENDERQUEUE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Export.hpp>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <map>
+#include <vector>
+
+
+namespace sf
+{
+class RenderTarget;
+class Sprite;
+
+////////////////////////////////////////////////////////////
+/// \brief Record draw commands and replay them sorted by
+///        render states
+///
+////////////////////////////////////////////////////////////
+class SFML_GRAPHICS_API RenderQueue
+{
+public:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// Creates an empty queue.
+    ///
+    ////////////////////////////////////////////////////////////
+    RenderQueue();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record primitives defined by an array of vertices
+    ///
+    /// The vertices are copied, the array can be destroyed
+    /// right after the call. The texture and shader of
+    /// \a states must exist until the queue is cleared.
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    /// \param layer       Layer of the command; lower layers are drawn first
+    /// \param depth       Order of the command among the ones that share
+    ///                    its layer, shader and texture (24 bits)
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const Vertex* vertices, std::size_t vertexCount, PrimitiveType type,
+              const RenderStates& states = RenderStates::Default, Uint8 layer = 0, Uint32 depth = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record a sprite
+    ///
+    /// The geometry, color and transform of the sprite are
+    /// copied; its texture must exist until the queue is
+    /// cleared. Sprites without a texture are ignored, like
+    /// when they are drawn directly.
+    ///
+    /// \param sprite Sprite to draw
+    /// \param states Render states to use for drawing
+    /// \param layer  Layer of the command; lower layers are drawn first
+    /// \param depth  Order of the command among the ones that share
+    ///               its layer, shader and texture (24 bits)
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const Sprite& sprite, const RenderStates& states = RenderStates::Default, Uint8 layer = 0, Uint32 depth = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw all the recorded commands to a render target
+    ///
+    /// The commands are sorted by layer, shader, texture and
+    /// depth, then drawn in that order. They are kept in the
+    /// queue, so that a static scene can be recorded once and
+    /// submitted every frame.
+    ///
+    /// \param target Render target to draw to
+    ///
+    ////////////////////////////////////////////////////////////
+    void submit(RenderTarget& target) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the recorded commands
+    ///
+    /// The memory is kept, so that recording again doesn't
+    /// reallocate anything.
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of recorded commands
+    ///
+    /// \return Number of commands in the queue
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getCommandCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the render states of a command, in drawing order
+    ///
+    /// \param index Position of the command in the sorted queue,
+    ///              in range [0 .. getCommandCount() - 1]
+    ///
+    /// \return Render states that the command is drawn with
+    ///
+    ////////////////////////////////////////////////////////////
+    const RenderStates& getStates(std::size_t index) const;
+
+private:
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record a command whose vertices are already in m_vertices
+    ///
+    /// \param first  Index of the first vertex of the command
+    /// \param type   Type of primitives to draw
+    /// \param states Render states to use for drawing
+    /// \param layer  Layer of the command
+    /// \param depth  Depth of the command
+    ///
+    ////////////////////////////////////////////////////////////
+    void addCommand(std::size_t first, PrimitiveType type, const RenderStates& states, Uint8 layer, Uint32 depth);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the small identifier used in sort keys for a resource
+    ///
+    /// Identifiers are given in order of first use, 0 is for NULL.
+    ///
+    /// \param ids      Identifiers already given
+    /// \param resource Texture or shader
+    /// \param maxId    Largest identifier that fits in the key
+    ///
+    /// \return Identifier of \a resource
+    ///
+    ////////////////////////////////////////////////////////////
+    static Uint32 getResourceId(std::map<const void*, Uint32>& ids, const void* resource, Uint32 maxId);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Sort the commands if new ones were recorded
+    ///
+    ////////////////////////////////////////////////////////////
+    void sort() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief A recorded draw command
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Command
+    {
+        std::size_t   first;  //!< Index of the first vertex in m_vertices
+        std::size_t   count;  //!< Number of vertices
+        PrimitiveType type;   //!< Type of primitives to draw
+        RenderStates  states; //!< Render states to use for drawing
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Sort key of a command, with the command it refers to
+    ///
+    ////////////////////////////////////////////////////////////
+    struct SortEntry
+    {
+        Uint64      key;   //!< Layer, shader, texture and depth packed from the highest bits to the lowest
+        std::size_t index; //!< Index of the command in m_commands
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Vertex>                m_vertices;   //!< Vertices of all the commands
+    std::vector<Command>               m_commands;   //!< Commands, in recording order
+    mutable std::vector<SortEntry>     m_order;      //!< Sort keys, in drawing order once sorted
+    mutable std::vector<SortEntry>     m_scratch;    //!< Temporary storage for the radix sort
+    mutable bool                       m_sorted;     //!< Is m_order sorted?
+    std::map<const void*, Uint32>      m_textureIds; //!< Identifiers of the textures used in the keys
+    std::map<const void*, Uint32>      m_shaderIds;  //!< Identifiers of the shaders used in the keys
+};
+
+} // namespace sf
+
+
+#endif // SFML_RENDERQUEUE_HPP
+
+
+////////////////////////////////////////////////////////////
+/// \class sf::RenderQueue
+/// \ingroup graphics
+///
+/// sf::RenderQueue collects draw commands and replays them to a
+/// render target in an order that minimizes render-state changes.
+/// Each command gets a 64-bit sort key made of its layer, shader,
+/// texture and depth, and the keys are sorted with a radix sort
+/// before drawing. Draws that alternate between a few textures,
+/// like tile maps or user interfaces, are therefore grouped so
+/// that each texture is bound once per layer instead of once per
+/// draw.
+///
+/// Layers are what guarantees drawing order: everything in a layer
+/// is drawn after everything in the lower layers. Inside a layer,
+/// commands are grouped by shader and texture, so draws that must
+/// appear above others with a different texture should go to a
+/// higher layer, or be ordered with the depth. Commands with the
+/// same key are drawn in the order they were recorded.
+///
+/// Commands are drawn with the regular draw functions of
+/// sf::RenderTarget. Enabling batching on the target (see
+/// sf::RenderTarget::setBatchingEnabled) additionally merges
+/// consecutive commands that share their render states into a
+/// single draw call.
+///
+/// Usage example:
+/// \code
+/// sf::RenderQueue queue;
+///
+/// // Ground tiles first, whatever their texture
+/// for (std::size_t i = 0; i < tiles.size(); ++i)
+///     queue.draw(tiles[i], sf::RenderStates::Default, 0);
+///
+/// // Then the characters, which share a texture, sorted by their vertical position
+/// for (std::size_t i = 0; i < characters.size(); ++i)
+///     queue.draw(characters[i], sf::RenderStates::Default, 1, static_cast<sf::Uint32>(characters[i].getPosition().y));
+///
+/// queue.submit(window);
+/// queue.clear();
+/// \endcode
+///
+/// \see sf::RenderTarget, sf::RenderStates
+///
+////////////////////////////////////////////////////////////
@@ -38,11 +38,13 @@
 #include <SFML/Graphics/PrimitiveType.hpp>
 #include <SFML/Graphics/Vertex.hpp>
 #include <SFML/System/NonCopyable.hpp>
+#include <vector>
 
 
 namespace sf
 {
 class Drawable;
+class InstancedSprite;
 class VertexBuffer;
 
 ////////////////////////////////////////////////////////////
@@ -268,6 +270,78 @@ public:
     ////////////////////////////////////////////////////////////
     void draw(const VertexBuffer& vertexBuffer, std::size_t firstVertex, std::size_t vertexCount, const RenderStates& states = RenderStates::Default);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw all the instances of an instanced sprite
+    ///
+    /// The texture of \a sprites replaces the one of \a states.
+    /// If instancing is not available, or if \a states has a
+    /// shader, the instances are expanded to triangles on the
+    /// CPU and drawn like an array of vertices.
+    ///
+    /// \param sprites Instanced sprite to draw
+    /// \param states  Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const InstancedSprite& sprites, const RenderStates& states = RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable or disable deferred batching of draw calls
+    ///
+    /// When batching is enabled, draw calls that take an array
+    /// of vertices are not sent to the graphics card right away.
+    /// Their vertices are transformed on the CPU and appended to
+    /// a single stream, and consecutive draws that use the same
+    /// texture, shader and blend mode are rendered together with
+    /// one OpenGL call. Strips, fans and quads are converted to
+    /// independent triangles (line strips to lines) so that they
+    /// can be merged with each other.
+    ///
+    /// The pending vertices are drawn when the render states
+    /// change, when the view changes, before a vertex buffer is
+    /// drawn, before the GL states are pushed, popped or reset,
+    /// when the target is deactivated, in RenderWindow::display()
+    /// and when flush() is called explicitly. sf::Window::display()
+    /// does not flush, so call flush() before displaying a render
+    /// window through a sf::Window reference.
+    ///
+    /// Since drawing is deferred, the textures and shaders used
+    /// must stay alive and unchanged until the batch is flushed:
+    /// call flush() before updating a texture or changing the
+    /// uniforms of a shader that is still in use, and before
+    /// reading back the contents of the target or issuing
+    /// OpenGL calls directly.
+    ///
+    /// Batching is disabled by default. Disabling it flushes
+    /// the pending vertices.
+    ///
+    /// \param enabled True to enable batching, false to disable it
+    ///
+    /// \see isBatchingEnabled, flush
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBatchingEnabled(bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether deferred batching is enabled
+    ///
+    /// \return True if batching is enabled, false otherwise
+    ///
+    /// \see setBatchingEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isBatchingEnabled() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the vertices that are waiting in the batch
+    ///
+    /// This function does nothing if batching is disabled or
+    /// if no vertices are pending.
+    ///
+    /// \see setBatchingEnabled
+    ///
+    ////////////////////////////////////////////////////////////
+    void flush();
+
     ////////////////////////////////////////////////////////////
     /// \brief Return the size of the rendering region of the target
     ///
@@ -458,6 +532,33 @@ private:
     ////////////////////////////////////////////////////////////
     void cleanupDraw(const RenderStates& states);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Append primitives to the deferred batch
+    ///
+    /// The pending batch is flushed first if it cannot be
+    /// merged with the new primitives.
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void batchPrimitives(const Vertex* vertices, std::size_t vertexCount,
+                         PrimitiveType type, const RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Send primitives to the graphics card right away
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void drawVertices(const Vertex* vertices, std::size_t vertexCount,
+                      PrimitiveType type, const RenderStates& states);
+
     ////////////////////////////////////////////////////////////
     /// \brief Render states cache
     ///
@@ -476,12 +577,27 @@ private:
         Vertex    vertexCache[VertexCacheSize]; //!< Pre-transformed vertices cache
     };
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Deferred draw call batch
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Batch
+    {
+        bool                enable;    //!< Is batching enabled?
+        PrimitiveType       type;      //!< Primitive type of the pending vertices (Points, Lines or Triangles)
+        BlendMode           blendMode; //!< Blend mode of the pending vertices
+        const Texture*      texture;   //!< Texture of the pending vertices
+        const Shader*       shader;    //!< Shader of the pending vertices
+        std::vector<Vertex> vertices;  //!< Pending vertices, already transformed
+    };
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
     View        m_defaultView; //!< Default view
     View        m_view;        //!< Current view
     StatesCache m_cache;       //!< Render states cache
+    Batch       m_batch;       //!< Deferred draw call batch
     Uint64      m_id;          //!< Unique number that identifies the RenderTarget
 };
 
@@ -141,6 +141,21 @@ public:
     ////////////////////////////////////////////////////////////
     bool setActive(bool active = true);
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Display on screen what has been rendered to the window so far
+    ///
+    /// This function draws the vertices that are still waiting
+    /// in the batch (see RenderTarget::setBatchingEnabled), then
+    /// behaves like sf::Window::display.
+    ///
+    /// It hides sf::Window::display rather than overriding it,
+    /// so that sf::Window keeps its layout and virtual table.
+    /// When a render window is displayed through a sf::Window
+    /// reference, call flush() first.
+    ///
+    ////////////////////////////////////////////////////////////
+    void display();
+
     ////////////////////////////////////////////////////////////
     /// \brief Copy the current contents of the window to an image
     ///
@@ -191,6 +191,8 @@ public:
 
 private:
 
+    friend class RenderQueue;
+
     ////////////////////////////////////////////////////////////
     /// \brief Draw the sprite to a render target
     ///
@@ -31,10 +31,13 @@
 #include <SFML/Graphics/Export.hpp>
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <cstddef>
 
 
 namespace sf
 {
+class Vertex;
+
 ////////////////////////////////////////////////////////////
 /// \brief Define a 3x3 transform matrix
 ///
@@ -130,6 +133,38 @@ public:
     ////////////////////////////////////////////////////////////
     Vector2f transformPoint(const Vector2f& point) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Transform an array of 2D points, in place
+    ///
+    /// The result is the same as calling transformPoint on
+    /// every point, but the points are processed several at
+    /// a time with SIMD instructions where the CPU has them
+    /// (SSE2 on x86, NEON on ARM). Use this function when a
+    /// large number of points share the same transform, like
+    /// the particles of a particle system.
+    ///
+    /// \param points Pointer to the first point to transform
+    /// \param count  Number of points to transform
+    ///
+    /// \see transformPoint
+    ///
+    ////////////////////////////////////////////////////////////
+    void transformPoints(Vector2f* points, std::size_t count) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Transform the positions of an array of vertices, in place
+    ///
+    /// Only the position of each vertex is modified, its color
+    /// and texture coordinates are left untouched.
+    ///
+    /// \param vertices    Pointer to the first vertex to transform
+    /// \param vertexCount Number of vertices to transform
+    ///
+    /// \see transformPoint
+    ///
+    ////////////////////////////////////////////////////////////
+    void transformPoints(Vertex* vertices, std::size_t vertexCount) const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Transform a rectangle
     ///
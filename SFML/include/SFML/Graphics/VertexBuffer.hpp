@@ -56,6 +56,14 @@ public:
     /// usage to Static. For everything else Dynamic should be a
     /// good compromise.
     ///
+    /// Once the whole contents of a Stream buffer have been
+    /// replaced twice, and if the system supports it, the next
+    /// replacements are written to another region of a buffer
+    /// three times larger instead of the one that the graphics
+    /// card may still be drawing from, so that the update never
+    /// has to wait for previous draws to finish. Buffers that are
+    /// filled only once or twice keep a single region.
+    ///
     ////////////////////////////////////////////////////////////
     enum Usage
     {
@@ -232,11 +240,27 @@ public:
     /// very specific stuff to implement that SFML doesn't support,
     /// or implement a temporary workaround until a bug is fixed.
     ///
+    /// The vertices of a Stream buffer don't necessarily start
+    /// at the beginning of the OpenGL buffer: draw them starting
+    /// at the vertex index returned by getNativeOffset, not at 0.
+    ///
     /// \return OpenGL handle of the vertex buffer or 0 if not yet created
     ///
     ////////////////////////////////////////////////////////////
     unsigned int getNativeHandle() const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the index of the first vertex in the underlying OpenGL buffer
+    ///
+    /// This is always 0, except for Stream buffers whose whole
+    /// contents are replaced repeatedly (see sf::VertexBuffer::Usage).
+    /// It can change after each call to update.
+    ///
+    /// \return Offset of the contents in the OpenGL buffer, in vertices
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getNativeOffset() const;
+
     ////////////////////////////////////////////////////////////
     /// \brief Set the type of primitives to draw
     ///
@@ -301,6 +325,9 @@ public:
     /// // draw OpenGL stuff that use no vertex buffer...
     /// \endcode
     ///
+    /// The first vertex of the buffer is at the index returned
+    /// by getNativeOffset, which isn't always 0 for Stream buffers.
+    ///
     /// \param vertexBuffer Pointer to the vertex buffer to bind, can be null to use no vertex buffer
     ///
     ////////////////////////////////////////////////////////////
@@ -318,6 +345,19 @@ public:
     ////////////////////////////////////////////////////////////
     static bool isAvailable();
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of bytes uploaded by all the vertex buffers
+    ///
+    /// The count covers every update from an array of vertices
+    /// since the program started. Read it once per frame and
+    /// subtract the previous value to get the bytes uploaded
+    /// per frame.
+    ///
+    /// \return Total number of bytes uploaded
+    ///
+    ////////////////////////////////////////////////////////////
+    static Uint64 getUploadedBytes();
+
 private:
 
     ////////////////////////////////////////////////////////////
@@ -329,6 +369,28 @@ private:
     ////////////////////////////////////////////////////////////
     virtual void draw(RenderTarget& target, RenderStates states) const;
 
+    ////////////////////////////////////////////////////////////
+    /// \brief Replace the whole contents through the streaming regions
+    ///
+    /// The buffer must be bound.
+    ///
+    /// \param vertices    Array of vertices to copy to the buffer
+    /// \param vertexCount Number of vertices to copy
+    ///
+    /// \return True if the vertices were written
+    ///
+    ////////////////////////////////////////////////////////////
+    bool stream(const Vertex* vertices, std::size_t vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Go back to a single region, dropping the fences
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetStreaming();
+
+    enum {StreamRegionCount = 3};      //!< Number of regions a Stream buffer cycles through
+    enum {StreamAfterFullUpdates = 2}; //!< Number of full updates a Stream buffer gets before it starts cycling
+
 private:
 
     ////////////////////////////////////////////////////////////
@@ -338,6 +400,10 @@ private:
     std::size_t   m_size;          //!< Size in Vertexes of the currently allocated buffer
     PrimitiveType m_primitiveType; //!< Type of primitives to draw
     Usage         m_usage;         //!< How this vertex buffer is to be used
+    std::size_t   m_regionCount;   //!< Number of regions of m_size vertices allocated in the buffer
+    std::size_t   m_region;        //!< Region that holds the current contents
+    void*         m_fences[StreamRegionCount]; //!< Fences signaled when the GPU is done with each region
+    unsigned int  m_fullUpdates;   //!< Number of updates that replaced the whole contents, up to StreamAfterFullUpdates + 1
 };
 
 } // namespace sf
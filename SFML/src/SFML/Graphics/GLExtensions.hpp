@@ -144,6 +144,33 @@
     #define GLEXT_GL_MIN                              GL_MIN_EXT
     #define GLEXT_GL_MAX                              GL_MAX_EXT
 
+    // Core since 3.0 - EXT_map_buffer_range
+    #define GLEXT_map_buffer_range                    false
+    #define GLEXT_glMapBufferRange                    glMapBufferRange // Placeholder to satisfy the compiler, entry point is not loaded in GLES
+    #define GLEXT_GL_MAP_WRITE_BIT                    0
+    #define GLEXT_GL_MAP_INVALIDATE_RANGE_BIT         0
+    #define GLEXT_GL_MAP_UNSYNCHRONIZED_BIT           0
+
+    // Core since 3.0 - APPLE_sync
+    #define GLEXT_sync                                false
+    #define GLEXT_GLsync                              GLsync
+    #define GLEXT_glFenceSync                         glFenceSync // Placeholder to satisfy the compiler, entry point is not loaded in GLES
+    #define GLEXT_glClientWaitSync                    glClientWaitSync // Placeholder to satisfy the compiler, entry point is not loaded in GLES
+    #define GLEXT_glDeleteSync                        glDeleteSync // Placeholder to satisfy the compiler, entry point is not loaded in GLES
+    #define GLEXT_GL_SYNC_GPU_COMMANDS_COMPLETE       0
+    #define GLEXT_GL_SYNC_FLUSH_COMMANDS_BIT          0
+    #define GLEXT_GL_TIMEOUT_EXPIRED                  0
+    #define GLEXT_GL_WAIT_FAILED                      0
+
+    // Core since 3.0 - EXT_instanced_arrays
+    #define GLEXT_instanced_arrays                    false
+    #define GLEXT_glDrawArraysInstanced               glDrawArraysInstanced // Placeholder to satisfy the compiler, entry point is not loaded in GLES
+    #define GLEXT_glVertexAttribDivisor               glVertexAttribDivisor // Placeholder to satisfy the compiler, entry point is not loaded in GLES
+    #define GLEXT_glVertexAttribPointer               glVertexAttribPointer // Placeholder to satisfy the compiler, entry point is not loaded in GLES
+    #define GLEXT_glEnableVertexAttribArray           glEnableVertexAttribArray // Placeholder to satisfy the compiler, entry point is not loaded in GLES
+    #define GLEXT_glDisableVertexAttribArray          glDisableVertexAttribArray // Placeholder to satisfy the compiler, entry point is not loaded in GLES
+    #define GLEXT_glGetAttribLocation                 glGetAttribLocation // Placeholder to satisfy the compiler, entry point is not loaded in GLES
+
 #else
 
     // SFML requires at a bare minimum OpenGL 1.1 capability
@@ -298,6 +325,13 @@
     #define GLEXT_glRenderbufferStorageMultisample    glRenderbufferStorageMultisampleEXT
     #define GLEXT_GL_MAX_SAMPLES                      GL_MAX_SAMPLES_EXT
 
+    // Core since 3.0 - ARB_map_buffer_range
+    #define GLEXT_map_buffer_range                    SF_GLAD_GL_ARB_map_buffer_range
+    #define GLEXT_glMapBufferRange                    glMapBufferRange
+    #define GLEXT_GL_MAP_WRITE_BIT                    GL_MAP_WRITE_BIT
+    #define GLEXT_GL_MAP_INVALIDATE_RANGE_BIT         GL_MAP_INVALIDATE_RANGE_BIT
+    #define GLEXT_GL_MAP_UNSYNCHRONIZED_BIT           GL_MAP_UNSYNCHRONIZED_BIT
+
     // Core since 3.1 - ARB_copy_buffer
     #define GLEXT_copy_buffer                         SF_GLAD_GL_ARB_copy_buffer
     #define GLEXT_GL_COPY_READ_BUFFER                 GL_COPY_READ_BUFFER
@@ -308,6 +342,27 @@
     #define GLEXT_geometry_shader4                    SF_GLAD_GL_ARB_geometry_shader4
     #define GLEXT_GL_GEOMETRY_SHADER                  GL_GEOMETRY_SHADER_ARB
 
+    // Core since 3.2 - ARB_sync
+    #define GLEXT_sync                                SF_GLAD_GL_ARB_sync
+    #define GLEXT_GLsync                              GLsync
+    #define GLEXT_glFenceSync                         glFenceSync
+    #define GLEXT_glClientWaitSync                    glClientWaitSync
+    #define GLEXT_glDeleteSync                        glDeleteSync
+    #define GLEXT_GL_SYNC_GPU_COMMANDS_COMPLETE       GL_SYNC_GPU_COMMANDS_COMPLETE
+    #define GLEXT_GL_SYNC_FLUSH_COMMANDS_BIT          GL_SYNC_FLUSH_COMMANDS_BIT
+    #define GLEXT_GL_TIMEOUT_EXPIRED                  GL_TIMEOUT_EXPIRED
+    #define GLEXT_GL_WAIT_FAILED                      GL_WAIT_FAILED
+
+    // Core since 3.3 - ARB_instanced_arrays, along with ARB_draw_instanced (core since 3.1)
+    // The loader doesn't include the ARB variants, so the core 3.3 entry points are required
+    #define GLEXT_instanced_arrays                    SF_GLAD_GL_VERSION_3_3
+    #define GLEXT_glDrawArraysInstanced               glDrawArraysInstanced
+    #define GLEXT_glVertexAttribDivisor               glVertexAttribDivisor
+    #define GLEXT_glVertexAttribPointer               glVertexAttribPointer
+    #define GLEXT_glEnableVertexAttribArray           glEnableVertexAttribArray
+    #define GLEXT_glDisableVertexAttribArray          glDisableVertexAttribArray
+    #define GLEXT_glGetAttribLocation                 glGetAttribLocation
+
 #endif
 
     // OpenGL Versions
@@ -0,0 +1,465 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/InstancedSprite.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <SFML/Graphics/GLCheck.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Lock.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+
+namespace
+{
+    // A nested named namespace is used here to allow unity builds of SFML.
+    namespace InstancedSpriteImpl
+    {
+        // Protects the availability check and the shared shader
+        sf::Mutex mutex;
+
+        // The built-in shader is compiled once and shared by all the instanced
+        // sprites that use it; it is destroyed with the last of them, so that
+        // it never outlives the OpenGL contexts
+        sf::Shader*  shader = NULL;
+        GLint        shaderAttributes[4];
+        unsigned int shaderUsers = 0;
+        bool         shaderFailed = false;
+
+        // The quad's corner comes from gl_Vertex, from (0, 0) to (1, 1); everything
+        // else comes from the instance. The result matches what sf::Sprite computes.
+        const char vertexShader[] =
+            "attribute vec3 row0;\n"
+            "attribute vec3 row1;\n"
+            "attribute vec4 textureRect;\n"
+            "attribute vec4 color;\n"
+            "\n"
+            "void main()\n"
+            "{\n"
+            "    vec2 corner = gl_Vertex.xy;\n"
+            "    vec3 local = vec3(corner * abs(textureRect.zw), 1.0);\n"
+            "    gl_Position = gl_ModelViewProjectionMatrix * vec4(dot(row0, local), dot(row1, local), 0.0, 1.0);\n"
+            "    gl_TexCoord[0] = gl_TextureMatrix[0] * vec4(textureRect.xy + corner * textureRect.zw, 0.0, 1.0);\n"
+            "    gl_FrontColor = color;\n"
+            "}\n";
+
+        const char fragmentShader[] =
+            "uniform sampler2D texture;\n"
+            "\n"
+            "void main()\n"
+            "{\n"
+            "    gl_FragColor = gl_Color * texture2D(texture, gl_TexCoord[0].xy);\n"
+            "}\n";
+
+        // Names, sizes and offsets of the per-instance attributes, in the order of InstancedSprite::m_attributes
+        const char* const attributeNames[]   = {"row0", "row1", "textureRect", "color"};
+        const GLint       attributeSizes[]   = {3, 3, 4, 4};
+        const std::size_t attributeOffsets[] = {0, 3 * sizeof(float), 6 * sizeof(float), 10 * sizeof(float)};
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+InstancedSprite::InstancedSprite() :
+m_texture           (NULL),
+m_instances         (),
+m_vertices          (),
+m_verticesNeedUpdate(true),
+m_buffer            (0),
+m_bufferNeedsUpdate (true),
+m_shader            (NULL)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+InstancedSprite::InstancedSprite(const Texture& texture) :
+m_texture           (&texture),
+m_instances         (),
+m_vertices          (),
+m_verticesNeedUpdate(true),
+m_buffer            (0),
+m_bufferNeedsUpdate (true),
+m_shader            (NULL)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+InstancedSprite::InstancedSprite(const InstancedSprite& copy) :
+Drawable            (copy),
+GlResource          (),
+m_texture           (copy.m_texture),
+m_instances         (copy.m_instances),
+m_vertices          (),
+m_verticesNeedUpdate(true),
+m_buffer            (0),
+m_bufferNeedsUpdate (true),
+m_shader            (NULL)
+{
+    // The OpenGL resources are created again on the first draw
+}
+
+
+////////////////////////////////////////////////////////////
+InstancedSprite::~InstancedSprite()
+{
+    if (m_buffer)
+    {
+        TransientContextLock contextLock;
+
+        glCheck(GLEXT_glDeleteBuffers(1, &m_buffer));
+    }
+
+    if (m_shader)
+    {
+        Lock lock(InstancedSpriteImpl::mutex);
+
+        if (--InstancedSpriteImpl::shaderUsers == 0)
+        {
+            delete InstancedSpriteImpl::shader;
+            InstancedSpriteImpl::shader = NULL;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+InstancedSprite& InstancedSprite::operator =(const InstancedSprite& right)
+{
+    // The buffer and shader of this object are kept, only the data is copied
+    m_texture = right.m_texture;
+    m_instances = right.m_instances;
+    m_verticesNeedUpdate = true;
+    m_bufferNeedsUpdate = true;
+
+    return *this;
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::setTexture(const Texture& texture)
+{
+    m_texture = &texture;
+}
+
+
+////////////////////////////////////////////////////////////
+const Texture* InstancedSprite::getTexture() const
+{
+    return m_texture;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t InstancedSprite::append(const Transform& transform, const IntRect& textureRect, const Color& color)
+{
+    m_instances.push_back(Instance());
+    setInstance(m_instances.size() - 1, transform, textureRect, color);
+
+    return m_instances.size() - 1;
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::setInstance(std::size_t index, const Transform& transform, const IntRect& textureRect, const Color& color)
+{
+    setTransform(index, transform);
+    setTextureRect(index, textureRect);
+    setColor(index, color);
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::setTransform(std::size_t index, const Transform& transform)
+{
+    assert(index < m_instances.size());
+
+    // Only the 2D affine part of the matrix is needed
+    const float* matrix = transform.getMatrix();
+    Instance& instance = m_instances[index];
+    instance.row0[0] = matrix[0]; instance.row0[1] = matrix[4]; instance.row0[2] = matrix[12];
+    instance.row1[0] = matrix[1]; instance.row1[1] = matrix[5]; instance.row1[2] = matrix[13];
+
+    m_verticesNeedUpdate = true;
+    m_bufferNeedsUpdate = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::setTextureRect(std::size_t index, const IntRect& textureRect)
+{
+    assert(index < m_instances.size());
+
+    Instance& instance = m_instances[index];
+    instance.textureRect[0] = static_cast<float>(textureRect.left);
+    instance.textureRect[1] = static_cast<float>(textureRect.top);
+    instance.textureRect[2] = static_cast<float>(textureRect.width);
+    instance.textureRect[3] = static_cast<float>(textureRect.height);
+
+    m_verticesNeedUpdate = true;
+    m_bufferNeedsUpdate = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::setColor(std::size_t index, const Color& color)
+{
+    assert(index < m_instances.size());
+
+    m_instances[index].color = color;
+
+    m_verticesNeedUpdate = true;
+    m_bufferNeedsUpdate = true;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t InstancedSprite::getInstanceCount() const
+{
+    return m_instances.size();
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::resize(std::size_t instanceCount)
+{
+    std::size_t previousCount = m_instances.size();
+    m_instances.resize(instanceCount);
+
+    IntRect wholeTexture;
+    if (m_texture)
+        wholeTexture = IntRect(0, 0, static_cast<int>(m_texture->getSize().x), static_cast<int>(m_texture->getSize().y));
+
+    for (std::size_t i = previousCount; i < instanceCount; ++i)
+        setInstance(i, Transform::Identity, wholeTexture, Color::White);
+
+    m_verticesNeedUpdate = true;
+    m_bufferNeedsUpdate = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::clear()
+{
+    m_instances.clear();
+
+    m_verticesNeedUpdate = true;
+    m_bufferNeedsUpdate = true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool InstancedSprite::isAvailable()
+{
+    Lock lock(InstancedSpriteImpl::mutex);
+
+    static bool checked = false;
+    static bool available = false;
+
+    if (!checked)
+    {
+        checked = true;
+
+        TransientContextLock contextLock;
+
+        // Make sure that extensions are initialized
+        sf::priv::ensureExtensionsInit();
+
+        available = GLEXT_instanced_arrays && VertexBuffer::isAvailable() && Shader::isAvailable();
+    }
+
+    return available;
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::draw(RenderTarget& target, RenderStates states) const
+{
+    target.draw(*this, states);
+}
+
+
+////////////////////////////////////////////////////////////
+bool InstancedSprite::prepareInstancing() const
+{
+    using namespace InstancedSpriteImpl;
+
+    // Get the shared shader the first time this object needs it
+    if (!m_shader)
+    {
+        Lock lock(mutex);
+
+        // Compile it if no other instanced sprite has, unless that already failed once
+        if (!shader && !shaderFailed)
+        {
+            shader = new Shader;
+
+            bool ready = shader->loadFromMemory(vertexShader, fragmentShader);
+
+            if (ready)
+            {
+                shader->setUniform("texture", Shader::CurrentTexture);
+
+                GLuint program = static_cast<GLuint>(shader->getNativeHandle());
+                for (int i = 0; i < 4; ++i)
+                {
+                    glCheck(shaderAttributes[i] = GLEXT_glGetAttribLocation(program, attributeNames[i]));
+
+                    if (shaderAttributes[i] < 0)
+                        ready = false;
+                }
+            }
+
+            if (!ready)
+            {
+                delete shader;
+                shader = NULL;
+                shaderFailed = true;
+            }
+        }
+
+        if (!shader)
+            return false;
+
+        ++shaderUsers;
+        m_shader = shader;
+        std::copy(shaderAttributes, shaderAttributes + 4, m_attributes);
+    }
+
+    if (!m_buffer)
+        glCheck(GLEXT_glGenBuffers(1, &m_buffer));
+
+    if (!m_buffer)
+        return false;
+
+    // Upload the instances if they changed, letting the driver orphan the previous storage
+    if (m_bufferNeedsUpdate)
+    {
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, m_buffer));
+        glCheck(GLEXT_glBufferData(GLEXT_GL_ARRAY_BUFFER, static_cast<GLsizeiptrARB>(sizeof(Instance) * m_instances.size()), &m_instances[0], GLEXT_GL_STREAM_DRAW));
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, 0));
+
+        m_bufferNeedsUpdate = false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSprite::bindInstanceAttributes(bool bind) const
+{
+    using namespace InstancedSpriteImpl;
+
+    if (bind)
+    {
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, m_buffer));
+
+        for (int i = 0; i < 4; ++i)
+        {
+            GLuint location = static_cast<GLuint>(m_attributes[i]);
+
+            // The color is made of bytes, normalized to [0, 1] like sf::Vertex colors
+            bool isColor = (i == 3);
+
+            glCheck(GLEXT_glEnableVertexAttribArray(location));
+            glCheck(GLEXT_glVertexAttribPointer(location, attributeSizes[i], isColor ? GL_UNSIGNED_BYTE : GL_FLOAT,
+                                                isColor ? GL_TRUE : GL_FALSE, sizeof(Instance),
+                                                reinterpret_cast<const void*>(attributeOffsets[i])));
+            glCheck(GLEXT_glVertexAttribDivisor(location, 1));
+        }
+
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, 0));
+    }
+    else
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            GLuint location = static_cast<GLuint>(m_attributes[i]);
+
+            glCheck(GLEXT_glVertexAttribDivisor(location, 0));
+            glCheck(GLEXT_glDisableVertexAttribArray(location));
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+const std::vector<Vertex>& InstancedSprite::getVertices() const
+{
+    if (m_verticesNeedUpdate)
+    {
+        m_vertices.resize(m_instances.size() * 6);
+
+        for (std::size_t i = 0; i < m_instances.size(); ++i)
+        {
+            const Instance& instance = m_instances[i];
+
+            float left   = instance.textureRect[0];
+            float top    = instance.textureRect[1];
+            float right  = left + instance.textureRect[2];
+            float bottom = top + instance.textureRect[3];
+            float width  = std::abs(instance.textureRect[2]);
+            float height = std::abs(instance.textureRect[3]);
+
+            // Same corners as sf::Sprite: top-left, bottom-left, top-right, bottom-right
+            Vertex corners[4];
+            corners[0] = Vertex(Vector2f(0,     0),      instance.color, Vector2f(left,  top));
+            corners[1] = Vertex(Vector2f(0,     height), instance.color, Vector2f(left,  bottom));
+            corners[2] = Vertex(Vector2f(width, 0),      instance.color, Vector2f(right, top));
+            corners[3] = Vertex(Vector2f(width, height), instance.color, Vector2f(right, bottom));
+
+            for (int j = 0; j < 4; ++j)
+            {
+                Vector2f local = corners[j].position;
+                corners[j].position.x = instance.row0[0] * local.x + instance.row0[1] * local.y + instance.row0[2];
+                corners[j].position.y = instance.row1[0] * local.x + instance.row1[1] * local.y + instance.row1[2];
+            }
+
+            Vertex* triangles = &m_vertices[i * 6];
+            triangles[0] = corners[0];
+            triangles[1] = corners[1];
+            triangles[2] = corners[2];
+            triangles[3] = corners[2];
+            triangles[4] = corners[1];
+            triangles[5] = corners[3];
+        }
+
+        m_verticesNeedUpdate = false;
+    }
+
+    return m_vertices;
+}
+
+} // namespace sf
@@ -0,0 +1,239 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2023 Laurent Gomila (laurent@sfml-dev.org)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/RenderQueue.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <algorithm>
+
+
+namespace
+{
+    // A nested named namespace is used here to allow unity builds of SFML.
+    namespace RenderQueueImpl
+    {
+        // Bits of each part of the sort keys, from the highest to the lowest
+        const unsigned int layerBits   = 8;
+        const unsigned int shaderBits  = 12;
+        const unsigned int textureBits = 20;
+        const unsigned int depthBits   = 24;
+
+        const sf::Uint32 maxShaderId  = (1u << shaderBits) - 1;
+        const sf::Uint32 maxTextureId = (1u << textureBits) - 1;
+        const sf::Uint32 depthMask    = (1u << depthBits) - 1;
+
+        sf::Uint64 makeKey(sf::Uint8 layer, sf::Uint32 shaderId, sf::Uint32 textureId, sf::Uint32 depth)
+        {
+            return (static_cast<sf::Uint64>(layer)     << (shaderBits + textureBits + depthBits)) |
+                   (static_cast<sf::Uint64>(shaderId)  << (textureBits + depthBits)) |
+                   (static_cast<sf::Uint64>(textureId) << depthBits) |
+                    static_cast<sf::Uint64>(depth & depthMask);
+        }
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+RenderQueue::RenderQueue() :
+m_vertices  (),
+m_commands  (),
+m_order     (),
+m_scratch   (),
+m_sorted    (true),
+m_textureIds(),
+m_shaderIds ()
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderQueue::draw(const Vertex* vertices, std::size_t vertexCount, PrimitiveType type, const RenderStates& states, Uint8 layer, Uint32 depth)
+{
+    // Nothing to draw?
+    if (!vertices || (vertexCount == 0))
+        return;
+
+    std::size_t first = m_vertices.size();
+    m_vertices.insert(m_vertices.end(), vertices, vertices + vertexCount);
+
+    addCommand(first, type, states, layer, depth);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderQueue::draw(const Sprite& sprite, const RenderStates& states, Uint8 layer, Uint32 depth)
+{
+    // Same as Sprite::draw
+    if (!sprite.m_texture)
+        return;
+
+    RenderStates spriteStates(states);
+    spriteStates.transform *= sprite.getTransform();
+    spriteStates.texture = sprite.m_texture;
+
+    std::size_t first = m_vertices.size();
+    m_vertices.insert(m_vertices.end(), sprite.m_vertices, sprite.m_vertices + 4);
+
+    addCommand(first, TriangleStrip, spriteStates, layer, depth);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderQueue::submit(RenderTarget& target) const
+{
+    sort();
+
+    for (std::vector<SortEntry>::const_iterator it = m_order.begin(); it != m_order.end(); ++it)
+    {
+        const Command& command = m_commands[it->index];
+        target.draw(&m_vertices[command.first], command.count, command.type, command.states);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderQueue::clear()
+{
+    m_vertices.clear();
+    m_commands.clear();
+    m_order.clear();
+    m_textureIds.clear();
+    m_shaderIds.clear();
+    m_sorted = true;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t RenderQueue::getCommandCount() const
+{
+    return m_commands.size();
+}
+
+
+////////////////////////////////////////////////////////////
+const RenderStates& RenderQueue::getStates(std::size_t index) const
+{
+    sort();
+
+    return m_commands[m_order[index].index].states;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderQueue::addCommand(std::size_t first, PrimitiveType type, const RenderStates& states, Uint8 layer, Uint32 depth)
+{
+    Command command;
+    command.first  = first;
+    command.count  = m_vertices.size() - first;
+    command.type   = type;
+    command.states = states;
+
+    SortEntry entry;
+    entry.key   = RenderQueueImpl::makeKey(layer,
+                                           getResourceId(m_shaderIds, states.shader, RenderQueueImpl::maxShaderId),
+                                           getResourceId(m_textureIds, states.texture, RenderQueueImpl::maxTextureId),
+                                           depth);
+    entry.index = m_commands.size();
+
+    m_commands.push_back(command);
+    m_order.push_back(entry);
+    m_sorted = false;
+}
+
+
+////////////////////////////////////////////////////////////
+Uint32 RenderQueue::getResourceId(std::map<const void*, Uint32>& ids, const void* resource, Uint32 maxId)
+{
+    if (!resource)
+        return 0;
+
+    std::map<const void*, Uint32>::const_iterator it = ids.find(resource);
+    if (it != ids.end())
+        return it->second;
+
+    // Past the limit, resources share the last identifier: they
+    // are still drawn correctly, just not grouped as well
+    Uint32 id = std::min(static_cast<Uint32>(ids.size() + 1), maxId);
+    ids.insert(std::make_pair(resource, id));
+
+    return id;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderQueue::sort() const
+{
+    if (m_sorted)
+        return;
+
+    m_sorted = true;
+
+    if (m_order.empty())
+        return;
+
+    // Count the occurrences of each value of each byte of the keys, all in one pass
+    std::size_t counts[8][256];
+    std::fill(&counts[0][0], &counts[0][0] + 8 * 256, 0);
+
+    for (std::vector<SortEntry>::const_iterator it = m_order.begin(); it != m_order.end(); ++it)
+    {
+        for (unsigned int byte = 0; byte < 8; ++byte)
+            ++counts[byte][(it->key >> (byte * 8)) & 0xFF];
+    }
+
+    m_scratch.resize(m_order.size());
+
+    // Least significant byte first; each pass is stable, so commands
+    // with equal keys keep the order in which they were recorded
+    for (unsigned int byte = 0; byte < 8; ++byte)
+    {
+        unsigned int shift = byte * 8;
+
+        // Skip the bytes that are the same in all the keys, they wouldn't move anything
+        if (counts[byte][(m_order[0].key >> shift) & 0xFF] == m_order.size())
+            continue;
+
+        // Turn the counts into the first position of each value
+        std::size_t position = 0;
+        for (unsigned int value = 0; value < 256; ++value)
+        {
+            std::size_t count = counts[byte][value];
+            counts[byte][value] = position;
+            position += count;
+        }
+
+        for (std::vector<SortEntry>::const_iterator it = m_order.begin(); it != m_order.end(); ++it)
+            m_scratch[counts[byte][(it->key >> shift) & 0xFF]++] = *it;
+
+        m_order.swap(m_scratch);
+    }
+}
+
+} // namespace sf
@@ -27,6 +27,7 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/InstancedSprite.hpp>
 #include <SFML/Graphics/Shader.hpp>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/VertexArray.hpp>
@@ -156,9 +157,14 @@ RenderTarget::RenderTarget() :
 m_defaultView(),
 m_view       (),
 m_cache      (),
+m_batch      (),
 m_id         (0)
 {
     m_cache.glStatesSet = false;
+    m_batch.enable = false;
+    m_batch.type = Triangles;
+    m_batch.texture = NULL;
+    m_batch.shader = NULL;
 }
 
 
@@ -171,6 +177,9 @@ RenderTarget::~RenderTarget()
 ////////////////////////////////////////////////////////////
 void RenderTarget::clear(const Color& color)
 {
+    // Whatever is still waiting in the batch would be cleared anyway
+    m_batch.vertices.clear();
+
     if (RenderTargetImpl::isActive(m_id) || setActive(true))
     {
         // Unbind texture to fix RenderTexture preventing clear
@@ -185,6 +194,9 @@ void RenderTarget::clear(const Color& color)
 ////////////////////////////////////////////////////////////
 void RenderTarget::setView(const View& view)
 {
+    // Pending vertices must be drawn with the view they were submitted with
+    flush();
+
     m_view = view;
     m_cache.viewChanged = true;
 }
@@ -286,65 +298,10 @@ void RenderTarget::draw(const Vertex* vertices, std::size_t vertexCount,
         }
     #endif
 
-    if (RenderTargetImpl::isActive(m_id) || setActive(true))
-    {
-        // Check if the vertex count is low enough so that we can pre-transform them
-        bool useVertexCache = (vertexCount <= StatesCache::VertexCacheSize);
-
-        if (useVertexCache)
-        {
-            // Pre-transform the vertices and store them into the vertex cache
-            for (std::size_t i = 0; i < vertexCount; ++i)
-            {
-                Vertex& vertex = m_cache.vertexCache[i];
-                vertex.position = states.transform * vertices[i].position;
-                vertex.color = vertices[i].color;
-                vertex.texCoords = vertices[i].texCoords;
-            }
-        }
-
-        setupDraw(useVertexCache, states);
-
-        // Check if texture coordinates array is needed, and update client state accordingly
-        bool enableTexCoordsArray = (states.texture || states.shader);
-        if (!m_cache.enable || (enableTexCoordsArray != m_cache.texCoordsArrayEnabled))
-        {
-            if (enableTexCoordsArray)
-                glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
-            else
-                glCheck(glDisableClientState(GL_TEXTURE_COORD_ARRAY));
-        }
-
-        // If we switch between non-cache and cache mode or enable texture
-        // coordinates we need to set up the pointers to the vertices' components
-        if (!m_cache.enable || !useVertexCache || !m_cache.useVertexCache)
-        {
-            const char* data = reinterpret_cast<const char*>(vertices);
-
-            // If we pre-transform the vertices, we must use our internal vertex cache
-            if (useVertexCache)
-                data = reinterpret_cast<const char*>(m_cache.vertexCache);
-
-            glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), data + 0));
-            glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), data + 8));
-            if (enableTexCoordsArray)
-                glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
-        }
-        else if (enableTexCoordsArray && !m_cache.texCoordsArrayEnabled)
-        {
-            // If we enter this block, we are already using our internal vertex cache
-            const char* data = reinterpret_cast<const char*>(m_cache.vertexCache);
-
-            glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
-        }
-
-        drawPrimitives(type, 0, vertexCount);
-        cleanupDraw(states);
-
-        // Update the cache
-        m_cache.useVertexCache = useVertexCache;
-        m_cache.texCoordsArrayEnabled = enableTexCoordsArray;
-    }
+    if (m_batch.enable)
+        batchPrimitives(vertices, vertexCount, type, states);
+    else
+        drawVertices(vertices, vertexCount, type, states);
 }
 
 
@@ -386,6 +343,9 @@ void RenderTarget::draw(const VertexBuffer& vertexBuffer, std::size_t firstVerte
         }
     #endif
 
+    // Vertex buffers are drawn directly, after whatever was submitted before them
+    flush();
+
     if (RenderTargetImpl::isActive(m_id) || setActive(true))
     {
         setupDraw(false, states);
@@ -401,7 +361,8 @@ void RenderTarget::draw(const VertexBuffer& vertexBuffer, std::size_t firstVerte
         glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), reinterpret_cast<const void*>(8)));
         glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<const void*>(12)));
 
-        drawPrimitives(vertexBuffer.getPrimitiveType(), firstVertex, vertexCount);
+        // Stream buffers may keep their vertices further in the OpenGL buffer
+        drawPrimitives(vertexBuffer.getPrimitiveType(), vertexBuffer.getNativeOffset() + firstVertex, vertexCount);
 
         // Unbind vertex buffer
         VertexBuffer::bind(NULL);
@@ -415,6 +376,104 @@ void RenderTarget::draw(const VertexBuffer& vertexBuffer, std::size_t firstVerte
 }
 
 
+////////////////////////////////////////////////////////////
+void RenderTarget::draw(const InstancedSprite& sprites, const RenderStates& states)
+{
+    // Nothing to draw?
+    if (sprites.getInstanceCount() == 0)
+        return;
+
+    RenderStates spriteStates(states);
+    spriteStates.texture = sprites.getTexture();
+
+    // Without instancing, or with a shader of the user's, expand the instances on the CPU
+    if (!spriteStates.texture || spriteStates.shader || !InstancedSprite::isAvailable())
+    {
+        const std::vector<Vertex>& vertices = sprites.getVertices();
+        draw(&vertices[0], vertices.size(), Triangles, spriteStates);
+        return;
+    }
+
+    // Instances are drawn directly, after whatever was submitted before them
+    flush();
+
+    if (RenderTargetImpl::isActive(m_id) || setActive(true))
+    {
+        if (!sprites.prepareInstancing())
+        {
+            const std::vector<Vertex>& vertices = sprites.getVertices();
+            draw(&vertices[0], vertices.size(), Triangles, spriteStates);
+            return;
+        }
+
+        spriteStates.shader = sprites.m_shader;
+        setupDraw(false, spriteStates);
+
+        // The shared quad only has positions, from (0, 0) to (1, 1);
+        // the colors and texture coordinates come from the instances
+        static const float corners[] = {0.f, 0.f, 0.f, 1.f, 1.f, 0.f, 1.f, 1.f};
+
+        if (VertexBuffer::isAvailable())
+            VertexBuffer::bind(NULL);
+
+        glCheck(glDisableClientState(GL_COLOR_ARRAY));
+        glCheck(glDisableClientState(GL_TEXTURE_COORD_ARRAY));
+        glCheck(glVertexPointer(2, GL_FLOAT, 0, corners));
+
+        sprites.bindInstanceAttributes(true);
+        glCheck(GLEXT_glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(sprites.getInstanceCount())));
+        sprites.bindInstanceAttributes(false);
+
+        glCheck(glEnableClientState(GL_COLOR_ARRAY));
+
+        cleanupDraw(spriteStates);
+
+        // Update the cache: the vertex pointers must be set again by the next draw
+        m_cache.useVertexCache = false;
+        m_cache.texCoordsArrayEnabled = false;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::setBatchingEnabled(bool enabled)
+{
+    if (!enabled)
+        flush();
+
+    m_batch.enable = enabled;
+}
+
+
+////////////////////////////////////////////////////////////
+bool RenderTarget::isBatchingEnabled() const
+{
+    return m_batch.enable;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::flush()
+{
+    if (m_batch.vertices.empty())
+        return;
+
+    // Take the vertices out of the batch first: drawing may reset the GL
+    // states or switch contexts, which flush again and must find it empty
+    std::vector<Vertex> vertices;
+    vertices.swap(m_batch.vertices);
+
+    // The vertices are already transformed, so they are drawn with an identity transform
+    RenderStates states(m_batch.blendMode, Transform::Identity, m_batch.texture, m_batch.shader);
+
+    drawVertices(&vertices[0], vertices.size(), m_batch.type, states);
+
+    // Give the storage back for the next batch
+    vertices.clear();
+    m_batch.vertices.swap(vertices);
+}
+
+
 ////////////////////////////////////////////////////////////
 bool RenderTarget::isSrgb() const
 {
@@ -467,6 +526,8 @@ bool RenderTarget::setActive(bool active)
 ////////////////////////////////////////////////////////////
 void RenderTarget::pushGLStates()
 {
+    flush();
+
     if (RenderTargetImpl::isActive(m_id) || setActive(true))
     {
         #ifdef SFML_DEBUG
@@ -499,6 +560,8 @@ void RenderTarget::pushGLStates()
 ////////////////////////////////////////////////////////////
 void RenderTarget::popGLStates()
 {
+    flush();
+
     if (RenderTargetImpl::isActive(m_id) || setActive(true))
     {
         glCheck(glMatrixMode(GL_PROJECTION));
@@ -518,6 +581,8 @@ void RenderTarget::popGLStates()
 ////////////////////////////////////////////////////////////
 void RenderTarget::resetGLStates()
 {
+    flush();
+
     // Check here to make sure a context change does not happen after activate(true)
     bool shaderAvailable = Shader::isAvailable();
     bool vertexBufferAvailable = VertexBuffer::isAvailable();
@@ -782,6 +847,156 @@ void RenderTarget::cleanupDraw(const RenderStates& states)
     m_cache.enable = true;
 }
 
+
+////////////////////////////////////////////////////////////
+void RenderTarget::batchPrimitives(const Vertex* vertices, std::size_t vertexCount,
+                                   PrimitiveType type, const RenderStates& states)
+{
+    // Strips, fans and quads can't be concatenated, they are
+    // converted to the list type of the same family instead
+    PrimitiveType batchType = Triangles;
+    if (type == Points)
+        batchType = Points;
+    else if ((type == Lines) || (type == LineStrip))
+        batchType = Lines;
+
+    // Start a new batch if the states don't match the pending one
+    if (!m_batch.vertices.empty() &&
+        ((batchType != m_batch.type) ||
+         (states.texture != m_batch.texture) ||
+         (states.shader != m_batch.shader) ||
+         (states.blendMode != m_batch.blendMode)))
+    {
+        flush();
+    }
+
+    m_batch.type = batchType;
+    m_batch.blendMode = states.blendMode;
+    m_batch.texture = states.texture;
+    m_batch.shader = states.shader;
+
+    // Find which source vertex goes at each position of the batch; for list
+    // types, a trailing incomplete primitive is dropped as OpenGL would do
+    std::size_t count = 0;
+    switch (type)
+    {
+        case Points:        count = vertexCount;                                  break;
+        case Lines:         count = vertexCount - vertexCount % 2;                break;
+        case LineStrip:     count = (vertexCount - 1) * 2;                        break;
+        case Triangles:     count = vertexCount - vertexCount % 3;                break;
+        case TriangleStrip:
+        case TriangleFan:   count = (vertexCount >= 3) ? (vertexCount - 2) * 3 : 0; break;
+        case Quads:         count = vertexCount / 4 * 6;                          break;
+    }
+
+    std::size_t first = m_batch.vertices.size();
+    m_batch.vertices.resize(first + count);
+    Vertex* out = count ? &m_batch.vertices[first] : NULL;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::size_t index = i;
+        switch (type)
+        {
+            case LineStrip:
+                index = i / 2 + i % 2;
+                break;
+
+            case TriangleStrip:
+            {
+                // Swap the first two vertices of every other triangle to keep the winding
+                std::size_t triangle = i / 3;
+                std::size_t corner = i % 3;
+                if ((triangle % 2) && (corner < 2))
+                    corner = 1 - corner;
+                index = triangle + corner;
+                break;
+            }
+
+            case TriangleFan:
+                index = (i % 3 == 0) ? 0 : i / 3 + i % 3;
+                break;
+
+            case Quads:
+            {
+                static const std::size_t corners[] = {0, 1, 2, 0, 2, 3};
+                index = i / 6 * 4 + corners[i % 6];
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        out[i] = vertices[index];
+    }
+
+    // Pre-transform the new vertices
+    if (states.transform != Transform::Identity)
+        states.transform.transformPoints(out, count);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderTarget::drawVertices(const Vertex* vertices, std::size_t vertexCount,
+                                PrimitiveType type, const RenderStates& states)
+{
+    if (RenderTargetImpl::isActive(m_id) || setActive(true))
+    {
+        // Check if the vertex count is low enough so that we can pre-transform them
+        bool useVertexCache = (vertexCount <= StatesCache::VertexCacheSize);
+
+        if (useVertexCache)
+        {
+            // Pre-transform the vertices and store them into the vertex cache
+            std::copy(vertices, vertices + vertexCount, m_cache.vertexCache);
+            states.transform.transformPoints(m_cache.vertexCache, vertexCount);
+        }
+
+        setupDraw(useVertexCache, states);
+
+        // Check if texture coordinates array is needed, and update client state accordingly
+        bool enableTexCoordsArray = (states.texture || states.shader);
+        if (!m_cache.enable || (enableTexCoordsArray != m_cache.texCoordsArrayEnabled))
+        {
+            if (enableTexCoordsArray)
+                glCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+            else
+                glCheck(glDisableClientState(GL_TEXTURE_COORD_ARRAY));
+        }
+
+        // If we switch between non-cache and cache mode or enable texture
+        // coordinates we need to set up the pointers to the vertices' components
+        if (!m_cache.enable || !useVertexCache || !m_cache.useVertexCache)
+        {
+            const char* data = reinterpret_cast<const char*>(vertices);
+
+            // If we pre-transform the vertices, we must use our internal vertex cache
+            if (useVertexCache)
+                data = reinterpret_cast<const char*>(m_cache.vertexCache);
+
+            glCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), data + 0));
+            glCheck(glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), data + 8));
+            if (enableTexCoordsArray)
+                glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
+        }
+        else if (enableTexCoordsArray && !m_cache.texCoordsArrayEnabled)
+        {
+            // If we enter this block, we are already using our internal vertex cache
+            const char* data = reinterpret_cast<const char*>(m_cache.vertexCache);
+
+            glCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), data + 12));
+        }
+
+        drawPrimitives(type, 0, vertexCount);
+        cleanupDraw(states);
+
+        // Update the cache
+        m_cache.useVertexCache = useVertexCache;
+        m_cache.texCoordsArrayEnabled = enableTexCoordsArray;
+    }
+}
+
 } // namespace sf
 
 
@@ -83,6 +83,10 @@ bool RenderWindow::isSrgb() const
 ////////////////////////////////////////////////////////////
 bool RenderWindow::setActive(bool active)
 {
+    // Pending batched vertices belong to this window's context
+    if (!active)
+        flush();
+
     bool result = Window::setActive(active);
 
     // Update RenderTarget tracking
@@ -102,6 +106,15 @@ bool RenderWindow::setActive(bool active)
 }
 
 
+////////////////////////////////////////////////////////////
+void RenderWindow::display()
+{
+    flush();
+
+    Window::display();
+}
+
+
 ////////////////////////////////////////////////////////////
 Image RenderWindow::capture() const
 {
@@ -26,8 +26,92 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Vertex.hpp>
 #include <cmath>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define SFML_TRANSFORM_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define SFML_TRANSFORM_NEON
+#endif
+
+
+namespace
+{
+    // A nested named namespace is used here to allow unity builds of SFML.
+    namespace TransformImpl
+    {
+        // Transform count points, each made of two floats, stored stride bytes apart.
+        // The SIMD paths pack two points into one 4-float register; wider registers
+        // would not help much since the points are rarely contiguous (sf::Vertex is
+        // 20 bytes) and have to be loaded one by one anyway.
+        void transformPoints(const float* matrix, char* data, std::size_t count, std::size_t stride)
+        {
+            std::size_t i = 0;
+
+        #if defined(SFML_TRANSFORM_SSE2)
+
+            const __m128 column0     = _mm_setr_ps(matrix[0],  matrix[1],  matrix[0],  matrix[1]);
+            const __m128 column1     = _mm_setr_ps(matrix[4],  matrix[5],  matrix[4],  matrix[5]);
+            const __m128 translation = _mm_setr_ps(matrix[12], matrix[13], matrix[12], matrix[13]);
+
+            for (; i + 2 <= count; i += 2)
+            {
+                __m64* first  = reinterpret_cast<__m64*>(data + i * stride);
+                __m64* second = reinterpret_cast<__m64*>(data + (i + 1) * stride);
+
+                // [x0, y0, x1, y1]
+                __m128 points = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), first), second);
+                __m128 x = _mm_shuffle_ps(points, points, _MM_SHUFFLE(2, 2, 0, 0));
+                __m128 y = _mm_shuffle_ps(points, points, _MM_SHUFFLE(3, 3, 1, 1));
+
+                __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, column0), _mm_mul_ps(y, column1)), translation);
+
+                _mm_storel_pi(first, result);
+                _mm_storeh_pi(second, result);
+            }
+
+        #elif defined(SFML_TRANSFORM_NEON)
+
+            const float column0Values[]     = {matrix[0],  matrix[1],  matrix[0],  matrix[1]};
+            const float column1Values[]     = {matrix[4],  matrix[5],  matrix[4],  matrix[5]};
+            const float translationValues[] = {matrix[12], matrix[13], matrix[12], matrix[13]};
+            const float32x4_t column0     = vld1q_f32(column0Values);
+            const float32x4_t column1     = vld1q_f32(column1Values);
+            const float32x4_t translation = vld1q_f32(translationValues);
+
+            for (; i + 2 <= count; i += 2)
+            {
+                float* first  = reinterpret_cast<float*>(data + i * stride);
+                float* second = reinterpret_cast<float*>(data + (i + 1) * stride);
+
+                // [x0, y0, x1, y1], then [x0, x0, x1, x1] and [y0, y0, y1, y1]
+                float32x4_t points = vcombine_f32(vld1_f32(first), vld1_f32(second));
+                float32x4x2_t xy = vtrnq_f32(points, points);
+
+                float32x4_t result = vaddq_f32(vaddq_f32(vmulq_f32(xy.val[0], column0), vmulq_f32(xy.val[1], column1)), translation);
+
+                vst1_f32(first, vget_low_f32(result));
+                vst1_f32(second, vget_high_f32(result));
+            }
+
+        #endif
+
+            // Remaining point, or all of them without SIMD
+            for (; i < count; ++i)
+            {
+                float* point = reinterpret_cast<float*>(data + i * stride);
+                float x = point[0];
+                float y = point[1];
+                point[0] = matrix[0] * x + matrix[4] * y + matrix[12];
+                point[1] = matrix[1] * x + matrix[5] * y + matrix[13];
+            }
+        }
+    }
+}
+
 
 namespace sf
 {
@@ -109,6 +193,22 @@ Vector2f Transform::transformPoint(const Vector2f& point) const
 }
 
 
+////////////////////////////////////////////////////////////
+void Transform::transformPoints(Vector2f* points, std::size_t count) const
+{
+    if (count > 0)
+        TransformImpl::transformPoints(m_matrix, reinterpret_cast<char*>(points), count, sizeof(Vector2f));
+}
+
+
+////////////////////////////////////////////////////////////
+void Transform::transformPoints(Vertex* vertices, std::size_t vertexCount) const
+{
+    if (vertexCount > 0)
+        TransformImpl::transformPoints(m_matrix, reinterpret_cast<char*>(&vertices[0].position), vertexCount, sizeof(Vertex));
+}
+
+
 ////////////////////////////////////////////////////////////
 FloatRect Transform::transformRect(const FloatRect& rectangle) const
 {
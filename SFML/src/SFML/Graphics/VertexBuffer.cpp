@@ -32,6 +32,7 @@
 #include <SFML/System/Mutex.hpp>
 #include <SFML/System/Lock.hpp>
 #include <SFML/System/Err.hpp>
+#include <algorithm>
 #include <cstring>
 
 namespace
@@ -41,6 +42,21 @@ namespace
     {
         sf::Mutex isAvailableMutex;
 
+        // Bytes uploaded by all the vertex buffers, for VertexBuffer::getUploadedBytes
+        sf::Mutex uploadedBytesMutex;
+        sf::Uint64 uploadedBytes = 0;
+
+        void countUploadedBytes(std::size_t bytes)
+        {
+            sf::Lock lock(uploadedBytesMutex);
+
+            uploadedBytes += bytes;
+        }
+
+        // How long a stream update waits for the GPU to release a region
+        // before giving up and letting the driver orphan the storage
+        const GLuint64 fenceTimeout = 1000000000; // 1 second, in nanoseconds
+
         GLenum usageToGlEnum(sf::VertexBuffer::Usage usage)
         {
             switch (usage)
@@ -61,8 +77,12 @@ VertexBuffer::VertexBuffer() :
 m_buffer       (0),
 m_size         (0),
 m_primitiveType(Points),
-m_usage        (Stream)
+m_usage        (Stream),
+m_regionCount  (1),
+m_region       (0),
+m_fullUpdates  (0)
 {
+    std::fill(m_fences, m_fences + StreamRegionCount, static_cast<void*>(NULL));
 }
 
 
@@ -71,8 +91,12 @@ VertexBuffer::VertexBuffer(PrimitiveType type) :
 m_buffer       (0),
 m_size         (0),
 m_primitiveType(type),
-m_usage        (Stream)
+m_usage        (Stream),
+m_regionCount  (1),
+m_region       (0),
+m_fullUpdates  (0)
 {
+    std::fill(m_fences, m_fences + StreamRegionCount, static_cast<void*>(NULL));
 }
 
 
@@ -81,8 +105,12 @@ VertexBuffer::VertexBuffer(VertexBuffer::Usage usage) :
 m_buffer       (0),
 m_size         (0),
 m_primitiveType(Points),
-m_usage        (usage)
+m_usage        (usage),
+m_regionCount  (1),
+m_region       (0),
+m_fullUpdates  (0)
 {
+    std::fill(m_fences, m_fences + StreamRegionCount, static_cast<void*>(NULL));
 }
 
 
@@ -91,8 +119,12 @@ VertexBuffer::VertexBuffer(PrimitiveType type, VertexBuffer::Usage usage) :
 m_buffer       (0),
 m_size         (0),
 m_primitiveType(type),
-m_usage        (usage)
+m_usage        (usage),
+m_regionCount  (1),
+m_region       (0),
+m_fullUpdates  (0)
 {
+    std::fill(m_fences, m_fences + StreamRegionCount, static_cast<void*>(NULL));
 }
 
 
@@ -101,8 +133,13 @@ VertexBuffer::VertexBuffer(const VertexBuffer& copy) :
 m_buffer       (0),
 m_size         (0),
 m_primitiveType(copy.m_primitiveType),
-m_usage        (copy.m_usage)
+m_usage        (copy.m_usage),
+m_regionCount  (1),
+m_region       (0),
+m_fullUpdates  (0)
 {
+    std::fill(m_fences, m_fences + StreamRegionCount, static_cast<void*>(NULL));
+
     if (copy.m_buffer && copy.m_size)
     {
         if (!create(copy.m_size))
@@ -124,6 +161,8 @@ VertexBuffer::~VertexBuffer()
     {
         TransientContextLock contextLock;
 
+        resetStreaming();
+
         glCheck(GLEXT_glDeleteBuffers(1, &m_buffer));
     }
 }
@@ -151,6 +190,8 @@ bool VertexBuffer::create(std::size_t vertexCount)
     glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, 0));
 
     m_size = vertexCount;
+    m_fullUpdates = 0;
+    resetStreaming();
 
     return true;
 }
@@ -187,15 +228,32 @@ bool VertexBuffer::update(const Vertex* vertices, std::size_t vertexCount, unsig
 
     glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, m_buffer));
 
+    VertexBufferImpl::countUploadedBytes(sizeof(Vertex) * vertexCount);
+
+    bool fullUpdate = (vertexCount > 0) && (vertexCount >= m_size);
+
+    if (fullUpdate && (m_fullUpdates <= StreamAfterFullUpdates))
+        ++m_fullUpdates;
+
+    // Stream buffers whose whole contents keep being replaced go to a region the GPU isn't reading;
+    // the first updates stay in a single region, many buffers are only filled once
+    if ((m_usage == Stream) && fullUpdate && (m_fullUpdates > StreamAfterFullUpdates) && stream(vertices, vertexCount))
+    {
+        glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, 0));
+
+        return true;
+    }
+
     // Check if we need to resize or orphan the buffer
     if (vertexCount >= m_size)
     {
         glCheck(GLEXT_glBufferData(GLEXT_GL_ARRAY_BUFFER, static_cast<GLsizeiptrARB>(sizeof(Vertex) * vertexCount), 0, VertexBufferImpl::usageToGlEnum(m_usage)));
 
         m_size = vertexCount;
+        resetStreaming();
     }
 
-    glCheck(GLEXT_glBufferSubData(GLEXT_GL_ARRAY_BUFFER, static_cast<GLintptrARB>(sizeof(Vertex) * offset), static_cast<GLsizeiptrARB>(sizeof(Vertex) * vertexCount), vertices));
+    glCheck(GLEXT_glBufferSubData(GLEXT_GL_ARRAY_BUFFER, static_cast<GLintptrARB>(sizeof(Vertex) * (getNativeOffset() + offset)), static_cast<GLsizeiptrARB>(sizeof(Vertex) * vertexCount), vertices));
 
     glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, 0));
 
@@ -226,7 +284,10 @@ bool VertexBuffer::update(const VertexBuffer& vertexBuffer)
         glCheck(GLEXT_glBindBuffer(GLEXT_GL_COPY_READ_BUFFER, vertexBuffer.m_buffer));
         glCheck(GLEXT_glBindBuffer(GLEXT_GL_COPY_WRITE_BUFFER, m_buffer));
 
-        glCheck(GLEXT_glCopyBufferSubData(GLEXT_GL_COPY_READ_BUFFER, GLEXT_GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(sizeof(Vertex) * vertexBuffer.m_size)));
+        glCheck(GLEXT_glCopyBufferSubData(GLEXT_GL_COPY_READ_BUFFER, GLEXT_GL_COPY_WRITE_BUFFER,
+                                          static_cast<GLintptr>(sizeof(Vertex) * vertexBuffer.getNativeOffset()),
+                                          static_cast<GLintptr>(sizeof(Vertex) * getNativeOffset()),
+                                          static_cast<GLsizeiptr>(sizeof(Vertex) * vertexBuffer.m_size)));
 
         glCheck(GLEXT_glBindBuffer(GLEXT_GL_COPY_WRITE_BUFFER, 0));
         glCheck(GLEXT_glBindBuffer(GLEXT_GL_COPY_READ_BUFFER, 0));
@@ -236,6 +297,7 @@ bool VertexBuffer::update(const VertexBuffer& vertexBuffer)
 
     glCheck(GLEXT_glBindBuffer(GLEXT_GL_ARRAY_BUFFER, m_buffer));
     glCheck(GLEXT_glBufferData(GLEXT_GL_ARRAY_BUFFER, static_cast<GLsizeiptrARB>(sizeof(Vertex) * vertexBuffer.m_size), 0, VertexBufferImpl::usageToGlEnum(m_usage)));
+    resetStreaming();
 
     void* destination = 0;
     glCheck(destination = GLEXT_glMapBuffer(GLEXT_GL_ARRAY_BUFFER, GLEXT_GL_WRITE_ONLY));
@@ -245,7 +307,7 @@ bool VertexBuffer::update(const VertexBuffer& vertexBuffer)
     void* source = 0;
     glCheck(source = GLEXT_glMapBuffer(GLEXT_GL_ARRAY_BUFFER, GLEXT_GL_READ_ONLY));
 
-    std::memcpy(destination, source, sizeof(Vertex) * vertexBuffer.m_size);
+    std::memcpy(destination, static_cast<const char*>(source) + sizeof(Vertex) * vertexBuffer.getNativeOffset(), sizeof(Vertex) * vertexBuffer.m_size);
 
     GLboolean sourceResult = GL_FALSE;
     glCheck(sourceResult = GLEXT_glUnmapBuffer(GLEXT_GL_ARRAY_BUFFER));
@@ -284,6 +346,10 @@ void VertexBuffer::swap(VertexBuffer& right)
     std::swap(m_buffer,        right.m_buffer);
     std::swap(m_primitiveType, right.m_primitiveType);
     std::swap(m_usage,         right.m_usage);
+    std::swap(m_regionCount,   right.m_regionCount);
+    std::swap(m_region,        right.m_region);
+    std::swap(m_fullUpdates,   right.m_fullUpdates);
+    std::swap_ranges(m_fences, m_fences + StreamRegionCount, right.m_fences);
 }
 
 
@@ -294,6 +360,13 @@ unsigned int VertexBuffer::getNativeHandle() const
 }
 
 
+////////////////////////////////////////////////////////////
+std::size_t VertexBuffer::getNativeOffset() const
+{
+    return m_region * m_size;
+}
+
+
 ////////////////////////////////////////////////////////////
 void VertexBuffer::bind(const VertexBuffer* vertexBuffer)
 {
@@ -358,6 +431,15 @@ bool VertexBuffer::isAvailable()
 }
 
 
+////////////////////////////////////////////////////////////
+Uint64 VertexBuffer::getUploadedBytes()
+{
+    Lock lock(VertexBufferImpl::uploadedBytesMutex);
+
+    return VertexBufferImpl::uploadedBytes;
+}
+
+
 ////////////////////////////////////////////////////////////
 void VertexBuffer::draw(RenderTarget& target, RenderStates states) const
 {
@@ -365,4 +447,102 @@ void VertexBuffer::draw(RenderTarget& target, RenderStates states) const
         target.draw(*this, 0, m_size, states);
 }
 
+
+////////////////////////////////////////////////////////////
+bool VertexBuffer::stream(const Vertex* vertices, std::size_t vertexCount)
+{
+#ifdef SFML_OPENGL_ES
+
+    (void) vertices;
+    (void) vertexCount;
+    return false;
+
+#else
+
+    // Make sure that extensions are initialized
+    sf::priv::ensureExtensionsInit();
+
+    if (!GLEXT_map_buffer_range || !GLEXT_sync)
+        return false;
+
+    const std::size_t regionBytes = sizeof(Vertex) * vertexCount;
+
+    bool reallocate = (m_regionCount != StreamRegionCount) || (vertexCount != m_size);
+
+    if (!reallocate)
+    {
+        // Everything that draws from the current region has been submitted by now,
+        // as long as the buffer is updated and drawn in the same context (the usual case)
+        GLEXT_GLsync fence = 0;
+        glCheck(fence = GLEXT_glFenceSync(GLEXT_GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        m_fences[m_region] = fence;
+
+        m_region = (m_region + 1) % StreamRegionCount;
+
+        // The next region was released two updates ago, so it is normally free already
+        if (m_fences[m_region])
+        {
+            GLEXT_GLsync nextFence = static_cast<GLEXT_GLsync>(m_fences[m_region]);
+
+            GLenum status = GLEXT_GL_WAIT_FAILED;
+            glCheck(status = GLEXT_glClientWaitSync(nextFence, GLEXT_GL_SYNC_FLUSH_COMMANDS_BIT, VertexBufferImpl::fenceTimeout));
+            glCheck(GLEXT_glDeleteSync(nextFence));
+            m_fences[m_region] = NULL;
+
+            if ((status == GLEXT_GL_TIMEOUT_EXPIRED) || (status == GLEXT_GL_WAIT_FAILED))
+                reallocate = true;
+        }
+    }
+
+    if (reallocate)
+    {
+        // New storage for all the regions, the previous one is orphaned
+        resetStreaming();
+
+        glCheck(GLEXT_glBufferData(GLEXT_GL_ARRAY_BUFFER, static_cast<GLsizeiptrARB>(regionBytes * StreamRegionCount), 0, GLEXT_GL_STREAM_DRAW));
+
+        m_size = vertexCount;
+        m_regionCount = StreamRegionCount;
+    }
+
+    // The region is known to be unused, so the driver doesn't have to synchronize
+    void* destination = 0;
+    glCheck(destination = GLEXT_glMapBufferRange(GLEXT_GL_ARRAY_BUFFER, static_cast<GLintptr>(regionBytes * m_region), static_cast<GLsizeiptr>(regionBytes),
+                                                 GLEXT_GL_MAP_WRITE_BIT | GLEXT_GL_MAP_INVALIDATE_RANGE_BIT | GLEXT_GL_MAP_UNSYNCHRONIZED_BIT));
+
+    GLboolean result = GL_FALSE;
+
+    if (destination)
+    {
+        std::memcpy(destination, vertices, regionBytes);
+
+        glCheck(result = GLEXT_glUnmapBuffer(GLEXT_GL_ARRAY_BUFFER));
+    }
+
+    // The mapping failed or its contents were lost, copy the vertices the regular way
+    if (result == GL_FALSE)
+        glCheck(GLEXT_glBufferSubData(GLEXT_GL_ARRAY_BUFFER, static_cast<GLintptrARB>(regionBytes * m_region), static_cast<GLsizeiptrARB>(regionBytes), vertices));
+
+    return true;
+
+#endif // SFML_OPENGL_ES
+}
+
+
+////////////////////////////////////////////////////////////
+void VertexBuffer::resetStreaming()
+{
+    for (std::size_t i = 0; i < StreamRegionCount; ++i)
+    {
+        if (m_fences[i])
+        {
+            glCheck(GLEXT_glDeleteSync(static_cast<GLEXT_GLsync>(m_fences[i])));
+            m_fences[i] = NULL;
+        }
+    }
+
+    m_regionCount = 1;
+    m_region = 0;
+}
+
 } // namespace sf
@@ -0,0 +1,102 @@
+#include <SFML/Graphics/RenderQueue.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include "GraphicsUtil.hpp"
+
+namespace
+{
+    // Record a point whose transform tells which command it is
+    void record(sf::RenderQueue& queue, int tag, const sf::Texture* texture, sf::Uint8 layer, sf::Uint32 depth = 0)
+    {
+        sf::Vertex vertex;
+        sf::RenderStates states;
+        states.transform.translate(static_cast<float>(tag), 0.f);
+        states.texture = texture;
+        queue.draw(&vertex, 1, sf::Points, states, layer, depth);
+    }
+
+    int tagAt(const sf::RenderQueue& queue, std::size_t index)
+    {
+        return static_cast<int>(queue.getStates(index).transform.getMatrix()[12]);
+    }
+}
+
+TEST_CASE("sf::RenderQueue class", "[graphics]")
+{
+    // The queue only compares texture pointers, real textures would need an OpenGL context
+    int textureStorage[2];
+    const sf::Texture* textureA = reinterpret_cast<const sf::Texture*>(&textureStorage[0]);
+    const sf::Texture* textureB = reinterpret_cast<const sf::Texture*>(&textureStorage[1]);
+    sf::RenderQueue queue;
+
+    SECTION("Empty queue")
+    {
+        CHECK(queue.getCommandCount() == 0);
+
+        sf::Vertex vertex;
+        queue.draw(&vertex, 0, sf::Points);
+        queue.draw(sf::Sprite());
+        CHECK(queue.getCommandCount() == 0);
+    }
+
+    SECTION("Layers are drawn in increasing order")
+    {
+        record(queue, 0, textureA, 2);
+        record(queue, 1, textureA, 0);
+        record(queue, 2, textureA, 255);
+        record(queue, 3, textureA, 1);
+
+        REQUIRE(queue.getCommandCount() == 4);
+        CHECK(tagAt(queue, 0) == 1);
+        CHECK(tagAt(queue, 1) == 3);
+        CHECK(tagAt(queue, 2) == 0);
+        CHECK(tagAt(queue, 3) == 2);
+    }
+
+    SECTION("Textures are grouped inside a layer, in recording order")
+    {
+        for (int i = 0; i < 6; ++i)
+            record(queue, i, (i % 2) ? textureB : textureA, 0);
+
+        REQUIRE(queue.getCommandCount() == 6);
+        const int expected[] = {0, 2, 4, 1, 3, 5};
+        for (std::size_t i = 0; i < 6; ++i)
+        {
+            CHECK(tagAt(queue, i) == expected[i]);
+            CHECK(queue.getStates(i).texture == ((i < 3) ? textureA : textureB));
+        }
+    }
+
+    SECTION("Depth orders commands that share their states")
+    {
+        record(queue, 0, textureA, 0, 300);
+        record(queue, 1, textureA, 0, 7);
+        record(queue, 2, textureA, 0, 70000);
+        record(queue, 3, textureA, 0, 7);
+
+        CHECK(tagAt(queue, 0) == 1);
+        CHECK(tagAt(queue, 1) == 3);
+        CHECK(tagAt(queue, 2) == 0);
+        CHECK(tagAt(queue, 3) == 2);
+    }
+
+    SECTION("Commands recorded after sorting")
+    {
+        record(queue, 0, textureB, 1);
+        record(queue, 1, textureA, 1);
+        CHECK(tagAt(queue, 0) == 0);
+
+        record(queue, 2, textureB, 0);
+        record(queue, 3, textureB, 1);
+
+        const int expected[] = {2, 0, 3, 1};
+        for (std::size_t i = 0; i < 4; ++i)
+            CHECK(tagAt(queue, i) == expected[i]);
+    }
+
+    SECTION("clear")
+    {
+        record(queue, 0, textureA, 0);
+        queue.clear();
+        CHECK(queue.getCommandCount() == 0);
+    }
+}
@@ -0,0 +1,63 @@
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include "GraphicsUtil.hpp"
+
+#include <vector>
+
+TEST_CASE("sf::Transform class", "[graphics]")
+{
+    sf::Transform transform;
+    transform.translate(12.5f, -7.f).rotate(30.f).scale(2.f, 0.5f);
+
+    SECTION("transformPoints")
+    {
+        // Odd and even counts, to cover both the SIMD path and the remainder
+        SECTION("Vector2f points")
+        {
+            for (std::size_t count = 0; count <= 9; ++count)
+            {
+                std::vector<sf::Vector2f> points;
+                for (std::size_t i = 0; i < count; ++i)
+                    points.push_back(sf::Vector2f(static_cast<float>(i) * 3.f - 10.f, 100.f - static_cast<float>(i)));
+
+                std::vector<sf::Vector2f> transformed = points;
+                transform.transformPoints(count ? &transformed[0] : NULL, count);
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    sf::Vector2f expected = transform.transformPoint(points[i]);
+                    CHECK(transformed[i].x == Approx(expected.x));
+                    CHECK(transformed[i].y == Approx(expected.y));
+                }
+            }
+        }
+
+        SECTION("Vertex positions")
+        {
+            for (std::size_t count = 0; count <= 9; ++count)
+            {
+                std::vector<sf::Vertex> vertices;
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    vertices.push_back(sf::Vertex(sf::Vector2f(static_cast<float>(i) * -4.f, static_cast<float>(i) * 2.f + 1.f),
+                                                  sf::Color(10, 20, 30, 40),
+                                                  sf::Vector2f(static_cast<float>(i), 5.f)));
+                }
+
+                std::vector<sf::Vertex> transformed = vertices;
+                transform.transformPoints(count ? &transformed[0] : NULL, count);
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    sf::Vector2f expected = transform.transformPoint(vertices[i].position);
+                    CHECK(transformed[i].position.x == Approx(expected.x));
+                    CHECK(transformed[i].position.y == Approx(expected.y));
+
+                    // Everything but the position is left alone
+                    CHECK(transformed[i].color == vertices[i].color);
+                    CHECK(transformed[i].texCoords == vertices[i].texCoords);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/System/Time.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cmath>
+
+// Fixed-step game loop shared by the games. The simulation runs in steps of
+// a fixed amount of simulated time, whatever the frame rate: each frame adds
+// its real elapsed time, and however many whole steps are due are run. The
+// time left over is a fraction of the next step, used to draw moving things
+// between their last two simulated positions.
+//
+//     timestep.addTime(frameTime);
+//     while (timestep.isStepDue())
+//     {
+//         // input up to now - timestep.getBacklog() belongs to this step
+//         timestep.takeStep();
+//         ...
+//     }
+//     draw(timestep.getAlpha());
+class FixedTimestep
+{
+public:
+    FixedTimestep(sf::Time step, int maxStepsPerFrame)
+        : m_step(step), m_maxStepsPerFrame(maxStepsPerFrame)
+    {
+    }
+
+    // Add a frame's elapsed time. At most maxStepsPerFrame steps are ever
+    // owed, so after a stall the game briefly runs slow instead of spiralling
+    // into ever longer frames.
+    void addTime(sf::Time elapsed)
+    {
+        m_backlog = std::min(m_backlog + elapsed, m_step * static_cast<sf::Int64>(m_maxStepsPerFrame));
+    }
+
+    bool isStepDue() const
+    {
+        return m_backlog >= m_step;
+    }
+
+    // Take one due step off the backlog
+    void takeStep()
+    {
+        m_backlog -= m_step;
+    }
+
+    // addTime(), then take every step that is due and return how many
+    int advance(sf::Time elapsed)
+    {
+        addTime(elapsed);
+        int steps = 0;
+        for (; isStepDue(); ++steps)
+        {
+            takeStep();
+        }
+        return steps;
+    }
+
+    // Simulated time still owed; the next step starts this long before now
+    sf::Time getBacklog() const
+    {
+        return m_backlog;
+    }
+
+    // Forget any time owed, e.g. while the game is paused
+    void reset()
+    {
+        m_backlog = sf::Time::Zero;
+    }
+
+    // How far into the next step the current frame is, from 0 to 1
+    float getAlpha() const
+    {
+        return m_backlog / m_step;
+    }
+
+    sf::Time getStep() const
+    {
+        return m_step;
+    }
+
+    float getStepSeconds() const
+    {
+        return m_step.asSeconds();
+    }
+
+private:
+    sf::Time m_step;
+    int m_maxStepsPerFrame;
+    sf::Time m_backlog;
+};
+
+// Jumps longer than this on either axis (respawns, resets) are drawn at the
+// current position instead of being smeared across the screen
+const float INTERPOLATION_SNAP_DISTANCE = 100.f;
+
+// How far from its current position to draw something alpha of the way from
+// its previous position
+inline sf::Vector2f interpolationOffset(sf::Vector2f previous, sf::Vector2f current, float alpha)
+{
+    sf::Vector2f offset = (previous - current) * (1.f - alpha);
+    if (std::abs(offset.x) >= INTERPOLATION_SNAP_DISTANCE || std::abs(offset.y) >= INTERPOLATION_SNAP_DISTANCE)
+    {
+        return sf::Vector2f(0.f, 0.f);
+    }
+    return offset;
+}
+
+// The same offset as a transform to draw with
+inline sf::Transform interpolate(sf::Vector2f previous, sf::Vector2f current, float alpha)
+{
+    sf::Transform transform;
+    transform.translate(interpolationOffset(previous, current, alpha));
+    return transform;
+}